@@ -3,10 +3,12 @@
 //
 
 #include "Application.h"
+#include "../rendering/GLMeshUploader.h"
 #include "../rendering/OpenGLUtils.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <filesystem>
 
 Application::Application() {
 }
@@ -30,10 +32,18 @@ bool Application::Initialize(const std::string& title, uint32_t width, uint32_t
     m_camera = std::make_unique<Camera>(60.0f, (float)width / height, 0.1f, 1000.0f);
     m_input = std::make_unique<Input>();
     m_renderer = std::make_unique<VoxelRenderer>();
-    m_chunkManager = std::make_unique<ChunkManager>();
+    m_chunkManager = std::make_unique<ChunkManager>(std::make_unique<GLMeshUploader>());
 
-    // Initialize components
-    m_chunkManager->Initialize();
+    ChunkManager::MemoryBudget budget;
+    budget.maxBytes = m_memoryBudgetMB * 1024 * 1024;
+    m_chunkManager->SetMemoryBudget(budget);
+
+    // Initialize components. Edits to a baked world are saved next to its own name.
+    if (!m_bakedWorldPath.empty() && m_chunkManager->OpenBakedWorld(m_bakedWorldPath)) {
+        m_chunkManager->Initialize("saves/" + std::filesystem::path(m_bakedWorldPath).stem().string());
+    } else {
+        m_chunkManager->Initialize();
+    }
     m_renderer->Initialize(width, height, m_chunkManager.get());
     m_renderer->UpdateCamera(m_camera.get());
 
@@ -164,6 +174,12 @@ void Application::ProcessEvents() {
                     m_mouseCaptured = !m_mouseCaptured;
                     SDL_SetWindowRelativeMouseMode(m_window, m_mouseCaptured);
                 }
+                if (event.key.key == SDLK_F3) {
+                    m_chunkManager->DumpLifecycleStats(std::cout);
+                }
+                if (event.key.key == SDLK_F4) {
+                    m_chunkManager->DumpMemoryStats(std::cout);
+                }
                 m_input->SetKeyDown(event.key.scancode);
                 break;
 
@@ -228,7 +244,7 @@ void Application::Update(float deltaTime) {
     }
 
     // Update world
-    m_chunkManager->Update(m_camera->GetPosition(), deltaTime);
+    m_chunkManager->Update(m_camera->GetPosition(), m_camera->GetForward(), deltaTime);
 
     // Update renderer
     m_renderer->UpdateCamera(m_camera.get());
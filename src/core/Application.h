@@ -23,6 +23,10 @@ public:
     void Run();
     void Shutdown();
 
+    // Must be set before Initialize()
+    void SetBakedWorldPath(const std::string& path) { m_bakedWorldPath = path; }
+    void SetMemoryBudget(size_t megabytes) { m_memoryBudgetMB = megabytes; } // 0 = unlimited
+
 private:
     bool InitializeSDL(const std::string& title);
     bool InitializeOpenGL();
@@ -44,6 +48,8 @@ private:
     std::unique_ptr<Input> m_input;
     std::unique_ptr<VoxelRenderer> m_renderer;
     std::unique_ptr<ChunkManager> m_chunkManager;
+    std::string m_bakedWorldPath;
+    size_t m_memoryBudgetMB = 0;
 
     // Timing
     uint64_t m_lastFrameTime;
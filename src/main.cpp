@@ -5,6 +5,7 @@
 #include "core/Application.h"
 #include <iostream>
 #include <stdexcept>
+#include <string>
 
 int main(int argc, char* argv[]) {
     std::cout << "========================================" << std::endl;
@@ -23,6 +24,16 @@ int main(int argc, char* argv[]) {
     try {
         Application app;
 
+        // --baked <file.vxb> streams a pre-generated world (see WorldBaker)
+        // --memory-budget <MB> caps chunk memory (CPU and GPU)
+        for (int i = 1; i + 1 < argc; ++i) {
+            if (std::string(argv[i]) == "--baked") {
+                app.SetBakedWorldPath(argv[i + 1]);
+            } else if (std::string(argv[i]) == "--memory-budget") {
+                app.SetMemoryBudget(std::stoul(argv[i + 1]));
+            }
+        }
+
         if (!app.Initialize("VoxelEngine - OpenGL Edition", 1280, 720)) {
             std::cerr << "Failed to initialize application!" << std::endl;
             return -1;
@@ -0,0 +1,69 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "GLMeshUploader.h"
+#include "OpenGLUtils.h"
+#include <cstddef>
+
+void GLMeshUploader::Upload(Chunk::MeshHandle& handle,
+                            const std::vector<Chunk::Vertex>& vertices,
+                            const std::vector<uint32_t>& indices) {
+    using Vertex = Chunk::Vertex;
+
+    if (handle.vao == 0) {
+        handle.vao = CreateVertexArray();
+        glGenBuffers(1, &handle.vbo);
+        glGenBuffers(1, &handle.ebo);
+        CheckGLError("Chunk OpenGL objects creation");
+    }
+
+    glBindVertexArray(handle.vao);
+
+    // Reuse the existing buffer storage when it is big enough, otherwise grow
+    // with some headroom so small edits don't reallocate every time
+    auto upload = [](GLenum target, GLuint buffer, const void* data, size_t bytes, size_t& capacity) {
+        glBindBuffer(target, buffer);
+        if (bytes <= capacity) {
+            glBufferSubData(target, 0, bytes, data);
+        } else {
+            capacity = bytes + bytes / 4;
+            glBufferData(target, capacity, nullptr, GL_STATIC_DRAW);
+            glBufferSubData(target, 0, bytes, data);
+        }
+    };
+
+    // Update vertex buffer
+    upload(GL_ARRAY_BUFFER, handle.vbo, vertices.data(), vertices.size() * sizeof(Vertex), handle.vertexCapacity);
+
+    // Update index buffer
+    upload(GL_ELEMENT_ARRAY_BUFFER, handle.ebo, indices.data(), indices.size() * sizeof(uint32_t), handle.indexCapacity);
+
+    // Set up vertex attributes
+    // Position
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+
+    // Normal
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+
+    // Texture coordinates
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
+
+    // Texture index
+    glEnableVertexAttribArray(3);
+    glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(Vertex), (void*)offsetof(Vertex, textureIndex));
+
+    glBindVertexArray(0);
+
+    CheckGLError("Chunk mesh update");
+}
+
+void GLMeshUploader::Release(Chunk::MeshHandle& handle) {
+    if (handle.vao) glDeleteVertexArrays(1, &handle.vao);
+    if (handle.vbo) glDeleteBuffers(1, &handle.vbo);
+    if (handle.ebo) glDeleteBuffers(1, &handle.ebo);
+    handle = Chunk::MeshHandle();
+}
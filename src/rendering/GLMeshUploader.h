@@ -0,0 +1,16 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "../world/MeshUploader.h"
+
+// Chunk meshes in OpenGL buffers: one VAO with a vertex and an index buffer per chunk
+class GLMeshUploader : public MeshUploader {
+public:
+    void Upload(Chunk::MeshHandle& handle,
+                const std::vector<Chunk::Vertex>& vertices,
+                const std::vector<uint32_t>& indices) override;
+    void Release(Chunk::MeshHandle& handle) override;
+};
@@ -4,6 +4,7 @@
 
 #include "Texture.h"
 #include "OpenGLUtils.h"
+#include "../utils/MemoryAccounting.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -22,6 +23,7 @@ Texture::~Texture() {
     if (m_textureID) {
         glDeleteTextures(1, &m_textureID);
     }
+    MemoryAccounting::Add(MemoryCategory::Textures, -static_cast<int64_t>(m_gpuBytes));
 }
 
 bool Texture::LoadFromFile(const std::string& filepath, int targetWidth, int targetHeight) {
@@ -91,6 +93,7 @@ bool Texture::Create(uint32_t width, uint32_t height, GLenum internalFormat, GLe
 
     glBindTexture(GL_TEXTURE_2D, m_textureID);
     glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, nullptr);
+    SetGpuBytes(static_cast<size_t>(width) * height * 4);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -104,6 +107,7 @@ bool Texture::Create(uint32_t width, uint32_t height, GLenum internalFormat, GLe
 void Texture::CreateFromData(const uint8_t* data) {
     glBindTexture(GL_TEXTURE_2D, m_textureID);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    SetGpuBytes(static_cast<size_t>(m_width) * m_height * 4);
 
     // Set texture parameters for pixel art
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -114,6 +118,11 @@ void Texture::CreateFromData(const uint8_t* data) {
     CheckGLError("Texture data upload");
 }
 
+void Texture::SetGpuBytes(size_t bytes) {
+    MemoryAccounting::Add(MemoryCategory::Textures, static_cast<int64_t>(bytes) - static_cast<int64_t>(m_gpuBytes));
+    m_gpuBytes = bytes;
+}
+
 std::vector<uint8_t> Texture::GenerateDefaultTexture(uint32_t width, uint32_t height) {
     std::vector<uint8_t> data(width * height * 4);
 
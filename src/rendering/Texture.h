@@ -37,6 +37,7 @@ public:
 
 private:
     void CreateFromData(const uint8_t* data);
+    void SetGpuBytes(size_t bytes);
     std::vector<uint8_t> ResizeImage(const uint8_t* data, int oldWidth, int oldHeight,
                                     int newWidth, int newHeight, int channels);
 
@@ -44,6 +45,7 @@ private:
     uint32_t m_width = 0;
     uint32_t m_height = 0;
     uint32_t m_channels = 4;
+    size_t m_gpuBytes = 0; // Level 0 storage, reported to MemoryAccounting
 };
 
 class TextureManager {
@@ -4,6 +4,7 @@
 
 #include "VoxelRenderer.h"
 #include "OpenGLUtils.h"
+#include "../utils/MemoryAccounting.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
@@ -17,6 +18,7 @@ VoxelRenderer::~VoxelRenderer() {
     }
     if (m_textureArray) {
         glDeleteTextures(1, &m_textureArray);
+        MemoryAccounting::Add(MemoryCategory::Textures, -static_cast<int64_t>(m_textureArrayBytes));
     }
 }
 
@@ -213,6 +215,10 @@ void VoxelRenderer::CreateTextures() {
     };
 
     m_textureArray = m_textureManager->CreateTextureArray(textureFiles, 16, 16);
+    if (m_textureArray) {
+        m_textureArrayBytes = 16 * 16 * 4 * textureFiles.size(); // RGBA8, no mipmaps
+        MemoryAccounting::Add(MemoryCategory::Textures, m_textureArrayBytes);
+    }
 
     CheckGLError("Texture creation");
 }
@@ -345,29 +351,16 @@ void VoxelRenderer::Render() {
     UpdateUniformBuffer();
     UpdateFrustumPlanes();
 
-    // Get visible chunks
-    std::vector<Chunk*> visibleChunks = m_chunkManager->GetVisibleChunks();
-
-    // Frustum culling
-    std::vector<Chunk*> culledChunks;
-    culledChunks.reserve(visibleChunks.size());
-
-    for (Chunk* chunk : visibleChunks) {
-        if (IsChunkInFrustum(chunk)) {
-            culledChunks.push_back(chunk);
-        }
-    }
-
-    // Render chunks
-    RenderChunks(culledChunks);
-
-    // Update statistics
-    m_renderedChunks = culledChunks.size();
+    // Visible chunks are kept up to date by the chunk manager - no copy needed
+    RenderChunks(m_chunkManager->GetVisibleChunks());
 
     CheckGLError("VoxelRenderer::Render");
 }
 
 void VoxelRenderer::RenderChunks(const std::vector<Chunk*>& chunks) {
+    m_renderedChunks = 0;
+    m_renderedTriangles = 0;
+
     if (chunks.empty()) return;
 
     // Use shader
@@ -383,18 +376,22 @@ void VoxelRenderer::RenderChunks(const std::vector<Chunk*>& chunks) {
         glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     }
 
-    m_renderedTriangles = 0;
-
     // Render each chunk
     for (Chunk* chunk : chunks) {
         if (chunk->GetIndexCount() == 0 || chunk->GetVAO() == 0) {
             continue; // Skip chunks without mesh or OpenGL objects
         }
 
+        // Frustum culling
+        if (!IsChunkInFrustum(chunk)) {
+            continue;
+        }
+
         // Bind VAO and draw
         glBindVertexArray(chunk->GetVAO());
         glDrawElements(GL_TRIANGLES, chunk->GetIndexCount(), GL_UNSIGNED_INT, 0);
 
+        m_renderedChunks++;
         m_renderedTriangles += chunk->GetIndexCount() / 3;
     }
 
@@ -47,7 +47,7 @@ private:
     void UpdateUniformBuffer();
     void SetupBlocks();
 
-    // Rendering
+    // Rendering (frustum culls while drawing)
     void RenderChunks(const std::vector<Chunk*>& chunks);
 
     // Frustum culling
@@ -60,6 +60,7 @@ private:
     // Textures
     std::unique_ptr<TextureManager> m_textureManager;
     GLuint m_textureArray = 0;
+    size_t m_textureArrayBytes = 0; // Reported to MemoryAccounting
 
     // Uniform buffer
     GLuint m_uniformBuffer = 0;
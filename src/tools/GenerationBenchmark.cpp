@@ -0,0 +1,273 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+// Generation benchmark and determinism check: generates an N x N x M box of
+// chunks through the GenerationPipeline on 1, 2, 4 ... maxThreads workers,
+// each run with a fresh generator (cold column cache). Reports chunks/s and
+// the time spent per stage, hashes every chunk and checks that all thread
+// counts produce the same world - and, with --golden, the same world as a
+// stored hash file.
+//
+// Usage: GenerationBenchmark [N=16] [M=6] [maxThreads=0] [--golden <file>] [--write-golden <file>]
+//
+// The box spans chunk columns [-N/2, N/2) on X and Z and chunk rows
+// [-2, M - 2) on Y. Exit code 1 when the output differs.
+
+#include "../world/GenerationPipeline.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int MIN_CHUNK_Y = -2;
+
+struct Region {
+    int size = 16;   // Chunk columns per side
+    int height = 6;  // Chunks per column
+
+    size_t GetChunkCount() const { return static_cast<size_t>(size) * size * height; }
+
+    // Column-major like ChunkManager requests them: all chunks of a column in a row
+    glm::ivec3 GetPosition(size_t index) const {
+        int y = static_cast<int>(index % height);
+        int column = static_cast<int>(index / height);
+        return glm::ivec3(column % size - size / 2, MIN_CHUNK_Y + y, column / size - size / 2);
+    }
+
+    size_t GetIndex(const glm::ivec3& position) const {
+        int column = (position.z + size / 2) * size + (position.x + size / 2);
+        return static_cast<size_t>(column) * height + (position.y - MIN_CHUNK_Y);
+    }
+};
+
+// FNV-1a over every block, x fastest
+uint64_t HashChunk(const Chunk& chunk) {
+    uint64_t hash = 1469598103934665603ull;
+    for (int y = 0; y < Chunk::HEIGHT; ++y) {
+        for (int z = 0; z < Chunk::SIZE; ++z) {
+            for (int x = 0; x < Chunk::SIZE; ++x) {
+                hash ^= static_cast<uint8_t>(chunk.GetBlock(x, y, z));
+                hash *= 1099511628211ull;
+            }
+        }
+    }
+    return hash;
+}
+
+struct RunResult {
+    double seconds = 0.0;
+    double stageMs[WorldGenerator::STAGE_COUNT] = {};
+    double columnMs = 0.0;
+    uint64_t columns = 0;
+    uint64_t parked = 0;
+    std::vector<uint64_t> hashes;
+};
+
+RunResult RunBenchmark(const Region& region, uint32_t threads) {
+    WorldGenerator generator;
+    generator.Initialize();
+
+    GenerationPool pool(threads);
+    GenerationPipeline pipeline(generator, pool);
+
+    RunResult result;
+    result.hashes.resize(region.GetChunkCount());
+
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+    size_t done = 0;
+
+    pool.Start();
+    auto start = std::chrono::steady_clock::now();
+
+    auto onGenerated = [&](std::unique_ptr<Chunk> chunk) {
+        result.hashes[region.GetIndex(chunk->GetPosition())] = HashChunk(*chunk);
+
+        std::lock_guard<std::mutex> lock(doneMutex);
+        if (++done == region.GetChunkCount()) {
+            doneCondition.notify_one();
+        }
+    };
+
+    // Submitted from workers like ChunkManager does; Submit() runs the stages
+    // it can inline, which must not happen on this thread
+    for (size_t i = 0; i < region.GetChunkCount(); ++i) {
+        glm::ivec3 position = region.GetPosition(i);
+        pool.Submit([&pipeline, &onGenerated, position] {
+            pipeline.Submit(std::make_unique<Chunk>(position), onGenerated);
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(doneMutex);
+        doneCondition.wait(lock, [&] { return done == region.GetChunkCount(); });
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    pool.Stop();
+
+    const double chunks = static_cast<double>(region.GetChunkCount());
+    for (size_t i = 0; i < WorldGenerator::STAGE_COUNT; ++i) {
+        result.stageMs[i] = pipeline.GetStageNanoseconds(static_cast<WorldGenerator::Stage>(i)) / 1e6 / chunks;
+    }
+    result.columnMs = pipeline.GetColumnNanoseconds() / 1e6 / std::max<uint64_t>(pipeline.GetColumnCount(), 1);
+    result.columns = pipeline.GetColumnCount();
+    result.parked = pipeline.GetParkCount();
+    return result;
+}
+
+// One "x y z hash" line per chunk
+bool WriteGolden(const std::string& path, const Region& region, const std::vector<uint64_t>& hashes) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        glm::ivec3 position = region.GetPosition(i);
+        file << position.x << " " << position.y << " " << position.z << " "
+             << std::hex << std::setw(16) << std::setfill('0') << hashes[i] << std::dec << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+// Number of chunks that differ from the golden file (missing ones included), or -1 if unreadable
+long CompareGolden(const std::string& path, const Region& region, const std::vector<uint64_t>& hashes) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to read " << path << std::endl;
+        return -1;
+    }
+
+    std::vector<bool> seen(hashes.size(), false);
+    long mismatches = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        glm::ivec3 position;
+        uint64_t expected = 0;
+        if (!(stream >> position.x >> position.y >> position.z >> std::hex >> expected)) {
+            continue;
+        }
+
+        // Golden files of a bigger box still apply to the chunks we have
+        if (position.x < -region.size / 2 || position.x >= region.size - region.size / 2 ||
+            position.z < -region.size / 2 || position.z >= region.size - region.size / 2 ||
+            position.y < MIN_CHUNK_Y || position.y >= MIN_CHUNK_Y + region.height) {
+            continue;
+        }
+
+        size_t index = region.GetIndex(position);
+        seen[index] = true;
+        if (hashes[index] != expected) {
+            if (mismatches < 10) {
+                std::cerr << "Chunk (" << position.x << ", " << position.y << ", " << position.z
+                          << ") differs from the golden hash" << std::endl;
+            }
+            mismatches++;
+        }
+    }
+
+    mismatches += static_cast<long>(std::count(seen.begin(), seen.end(), false));
+    return mismatches;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> positional;
+    std::string goldenPath;
+    std::string writeGoldenPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--golden" && i + 1 < argc) {
+            goldenPath = argv[++i];
+        } else if (arg == "--write-golden" && i + 1 < argc) {
+            writeGoldenPath = argv[++i];
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    Region region;
+    region.size = positional.size() > 0 ? std::stoi(positional[0]) : 16;
+    region.height = positional.size() > 1 ? std::stoi(positional[1]) : 6;
+    uint32_t maxThreads = positional.size() > 2 ? static_cast<uint32_t>(std::stoul(positional[2])) : 0;
+    if (maxThreads == 0) {
+        maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    if (region.size <= 0 || region.height <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [N=16] [M=6] [maxThreads=0]"
+                  << " [--golden <file>] [--write-golden <file>]" << std::endl;
+        return 1;
+    }
+
+    Block::Initialize();
+
+    std::cout << "Generating " << region.size << "x" << region.size << "x" << region.height << " chunks ("
+              << region.GetChunkCount() << ") on 1.." << maxThreads << " threads" << std::endl;
+
+    std::vector<uint64_t> reference;
+    bool deterministic = true;
+    double singleThreadSeconds = 0.0;
+
+    for (uint32_t threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        RunResult result = RunBenchmark(region, threads);
+        if (threads == 1) {
+            singleThreadSeconds = result.seconds;
+        }
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(3) << threads << " threads: " << std::setw(8) << region.GetChunkCount() / result.seconds
+                  << " chunks/s, x" << std::setprecision(2) << singleThreadSeconds / result.seconds
+                  << std::setprecision(3) << " | ms/chunk:";
+        for (size_t i = 0; i < WorldGenerator::STAGE_COUNT; ++i) {
+            std::cout << " " << WorldGenerator::GetStageInfo(static_cast<WorldGenerator::Stage>(i)).name
+                      << " " << result.stageMs[i];
+        }
+        std::cout << " | " << result.columns << " columns at " << result.columnMs << " ms, "
+                  << result.parked << " parked" << std::endl;
+
+        if (reference.empty()) {
+            reference = std::move(result.hashes);
+        } else if (result.hashes != reference) {
+            std::cerr << "Output on " << threads << " threads differs from 1 thread" << std::endl;
+            deterministic = false;
+        }
+
+        if (threads == maxThreads) {
+            break;
+        }
+    }
+
+    if (!writeGoldenPath.empty()) {
+        if (!WriteGolden(writeGoldenPath, region, reference)) {
+            return 1;
+        }
+        std::cout << "Golden hashes written to " << writeGoldenPath << std::endl;
+    }
+
+    if (!goldenPath.empty()) {
+        long mismatches = CompareGolden(goldenPath, region, reference);
+        if (mismatches != 0) {
+            std::cerr << "Golden check failed: " << (mismatches < 0 ? "unreadable file" : std::to_string(mismatches) + " chunks differ")
+                      << std::endl;
+            return 1;
+        }
+        std::cout << "Golden check passed" << std::endl;
+    }
+
+    return deterministic ? 0 : 1;
+}
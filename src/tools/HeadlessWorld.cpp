@@ -0,0 +1,179 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+// Headless soak test: drives ChunkManager along a scripted viewer path with
+// no window or OpenGL context (meshes go to a NullMeshUploader) and reports
+// streaming throughput and chunk lifecycle latency.
+//
+// Usage: VoxelHeadless [seconds=60] [speed=16] [threads=0] [worldDir=saves/headless]
+//                      [--baked <file.vxb>] [--memory-budget <MB>]
+
+#include "../world/ChunkManager.h"
+#include "../world/ColumnCache.h"
+#include "../utils/MemoryAccounting.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr float FRAME_TIME = 1.0f / 60.0f;  // Simulated frame pacing
+constexpr float REPORT_INTERVAL = 5.0f;     // Seconds between progress lines
+constexpr float CRUISE_HEIGHT = 48.0f;
+constexpr float CIRCLE_RADIUS = 256.0f;
+
+// Straight flight along +X for the first third, then a wide circle, with a slow
+// climb and dive throughout - covers forward streaming, turning and vertical moves
+glm::vec3 GetViewerPosition(float time, float duration, float speed) {
+    const float straightTime = duration / 3.0f;
+    float height = CRUISE_HEIGHT + 24.0f * std::sin(time * 0.1f);
+
+    if (time <= straightTime) {
+        return glm::vec3(speed * time, height, 0.0f);
+    }
+
+    const float angle = speed * (time - straightTime) / CIRCLE_RADIUS;
+    const glm::vec3 center(speed * straightTime, 0.0f, CIRCLE_RADIUS);
+    return center + glm::vec3(CIRCLE_RADIUS * std::sin(angle), height, -CIRCLE_RADIUS * std::cos(angle));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> positional;
+    std::string bakedWorldPath;
+    size_t memoryBudgetMB = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--baked" && i + 1 < argc) {
+            bakedWorldPath = argv[++i];
+        } else if (arg == "--memory-budget" && i + 1 < argc) {
+            memoryBudgetMB = std::stoul(argv[++i]);
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    const float duration = positional.size() > 0 ? std::stof(positional[0]) : 60.0f;
+    const float speed = positional.size() > 1 ? std::stof(positional[1]) : 16.0f;
+    const uint32_t threads = positional.size() > 2 ? static_cast<uint32_t>(std::stoul(positional[2])) : 0;
+    const std::string worldDirectory = positional.size() > 3 ? positional[3] : "saves/headless";
+
+    if (duration <= 0.0f || speed < 0.0f) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [seconds=60] [speed=16] [threads=0] [worldDir=saves/headless]"
+                  << " [--baked <file.vxb>] [--memory-budget <MB>]" << std::endl;
+        return 1;
+    }
+
+    auto uploader = std::make_unique<NullMeshUploader>();
+    const NullMeshUploader* meshes = uploader.get();
+
+    ChunkManager chunkManager(std::move(uploader), threads);
+
+    ChunkManager::MemoryBudget budget;
+    budget.maxBytes = memoryBudgetMB * 1024 * 1024;
+    chunkManager.SetMemoryBudget(budget);
+    if (!bakedWorldPath.empty() && !chunkManager.OpenBakedWorld(bakedWorldPath)) {
+        std::cerr << "Failed to open baked world " << bakedWorldPath << std::endl;
+        return 1;
+    }
+    chunkManager.Initialize(worldDirectory);
+
+    std::cout << "Headless run: " << duration << "s at " << speed << " blocks/s, "
+              << chunkManager.GetGenerationThreadCount() << " generation threads" << std::endl;
+
+    const ChunkLifecycle& lifecycle = chunkManager.GetLifecycle();
+    const LatencyHistogram& generated = lifecycle.GetStageLatency(ChunkState::Generating);
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    Clock::time_point lastFrame = start;
+    Clock::time_point nextFrame = start;
+
+    float time = 0.0f;
+    float reportTimer = 0.0f;
+    uint64_t frames = 0;
+    uint64_t reportFrames = 0;
+    double reportFrameTime = 0.0;
+    double reportMaxFrameTime = 0.0;
+    uint64_t lastGenerated = 0;
+    uint64_t lastUploads = 0;
+
+    while (time < duration) {
+        Clock::time_point now = Clock::now();
+        float deltaTime = std::chrono::duration<float>(now - lastFrame).count();
+        lastFrame = now;
+        time = std::chrono::duration<float>(now - start).count();
+
+        glm::vec3 position = GetViewerPosition(time, duration, speed);
+        glm::vec3 ahead = GetViewerPosition(time + FRAME_TIME, duration, speed) - position;
+        glm::vec3 direction = glm::length(ahead) > 0.0f ? glm::normalize(ahead) : glm::vec3(1.0f, 0.0f, 0.0f);
+
+        chunkManager.Update(position, direction, deltaTime);
+
+        double frameTime = std::chrono::duration<double>(Clock::now() - now).count();
+        reportFrameTime += frameTime;
+        reportMaxFrameTime = std::max(reportMaxFrameTime, frameTime);
+        frames++;
+        reportFrames++;
+
+        reportTimer += deltaTime;
+        if (reportTimer >= REPORT_INTERVAL) {
+            uint64_t generatedCount = generated.GetCount();
+            uint64_t uploadCount = meshes->GetUploadCount();
+            ChunkManager::MemoryUsage memory = chunkManager.GetMemoryUsage();
+
+            std::cout << "[" << static_cast<int>(time) << "s] chunks " << chunkManager.GetLoadedChunkCount()
+                      << ", visible " << chunkManager.GetVisibleChunks().size()
+                      << ", queued " << chunkManager.GetGenerationQueueSize()
+                      << ", compressed " << chunkManager.GetCompressedChunkCount()
+                      << " | " << memory.GetTotal() / (1024 * 1024) << " MB"
+                      << " (peak " << MemoryAccounting::GetTotalPeak() / (1024 * 1024) << " MB)"
+                      << " | " << (generatedCount - lastGenerated) / reportTimer << " chunks/s"
+                      << ", " << (uploadCount - lastUploads) / reportTimer << " meshes/s"
+                      << " | update " << reportFrameTime / reportFrames * 1000.0 << " ms avg, "
+                      << reportMaxFrameTime * 1000.0 << " ms max" << std::endl;
+
+            lastGenerated = generatedCount;
+            lastUploads = uploadCount;
+            reportTimer = 0.0f;
+            reportFrames = 0;
+            reportFrameTime = 0.0;
+            reportMaxFrameTime = 0.0;
+        }
+
+        nextFrame += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(FRAME_TIME));
+        std::this_thread::sleep_until(nextFrame);
+    }
+
+    const float elapsed = std::chrono::duration<float>(Clock::now() - start).count();
+    std::cout << "========================================" << std::endl;
+    std::cout << "Frames: " << frames << " in " << elapsed << "s" << std::endl;
+    std::cout << "Chunks generated: " << generated.GetCount() << " (" << generated.GetCount() / elapsed << "/s)" << std::endl;
+    std::cout << "Meshes uploaded: " << meshes->GetUploadCount() << " ("
+              << meshes->GetUploadedBytes() / (1024.0 * 1024.0) << " MB)" << std::endl;
+    std::cout << "Chunk memory: " << chunkManager.GetTotalMemoryUsage() / 1024 << " KB in "
+              << chunkManager.GetLoadedChunkCount() << " chunks" << std::endl;
+    std::cout << "Prefetch hit rate: " << chunkManager.GetPrefetcher().GetHitRate() * 100.0f << "%" << std::endl;
+    std::cout << "Column cache hit rate: " << chunkManager.GetWorldGenerator().GetColumnCache().GetHitRate() * 100.0f
+              << "%" << std::endl;
+
+    const GenerationPipeline& pipeline = chunkManager.GetGenerationPipeline();
+    std::cout << "Generation stages (ms/chunk):";
+    for (size_t i = 0; i < WorldGenerator::STAGE_COUNT; ++i) {
+        auto stage = static_cast<WorldGenerator::Stage>(i);
+        std::cout << " " << WorldGenerator::GetStageInfo(stage).name << " "
+                  << pipeline.GetStageNanoseconds(stage) / 1e6 / std::max<uint64_t>(pipeline.GetCompletedCount(), 1);
+    }
+    std::cout << ", " << pipeline.GetParkCount() << " parked on columns" << std::endl;
+    chunkManager.DumpLifecycleStats(std::cout);
+    chunkManager.DumpMemoryStats(std::cout);
+
+    return 0;
+}
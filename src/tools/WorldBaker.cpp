@@ -0,0 +1,89 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+// Offline baking tool: runs WorldGenerator over a box of chunks and writes a
+// memory-mappable baked world that VoxelEngine can load with --baked.
+//
+// Usage: WorldBaker <output.vxb> [radius=32] [minChunkY=-2] [maxChunkY=4]
+
+#include "../world/BakedWorld.h"
+#include "../world/WorldGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <output.vxb> [radius=32] [minChunkY=-2] [maxChunkY=4]" << std::endl;
+        return 1;
+    }
+
+    const std::string outputPath = argv[1];
+    const int radius = argc > 2 ? std::stoi(argv[2]) : 32;
+    const int minY = argc > 3 ? std::stoi(argv[3]) : -2;
+    const int maxY = argc > 4 ? std::stoi(argv[4]) : 4;
+
+    if (radius < 0 || minY > maxY) {
+        std::cerr << "Invalid bounds" << std::endl;
+        return 1;
+    }
+
+    Block::Initialize();
+    WorldGenerator generator;
+    generator.Initialize();
+
+    // One job per chunk column
+    const int side = radius * 2 + 1;
+    const int columnCount = side * side;
+    std::atomic<int> nextColumn{0};
+
+    BakedWorld::Writer writer;
+    std::mutex writerMutex;
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        while (true) {
+            int column = nextColumn.fetch_add(1);
+            if (column >= columnCount) {
+                break;
+            }
+
+            int x = column % side - radius;
+            int z = column / side - radius;
+            for (int y = minY; y <= maxY; ++y) {
+                Chunk chunk(glm::ivec3(x, y, z));
+                generator.GenerateChunk(&chunk);
+
+                std::lock_guard<std::mutex> lock(writerMutex);
+                writer.AddChunk(chunk);
+            }
+        }
+    };
+
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Generated " << columnCount * (maxY - minY + 1) << " chunks in " << elapsed << "s ("
+              << writer.GetChunkCount() << " non-empty)" << std::endl;
+
+    if (!writer.Write(outputPath)) {
+        return 1;
+    }
+
+    std::cout << "Baked world written to " << outputPath << std::endl;
+    return 0;
+}
@@ -0,0 +1,94 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "EpochReclaimer.h"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <thread>
+
+EpochReclaimer::EpochReclaimer() = default;
+
+EpochReclaimer::~EpochReclaimer() {
+    CollectAll();
+}
+
+EpochReclaimer::Guard EpochReclaimer::Pin() {
+    // Start probing at a per-thread slot so threads rarely contend for a record
+    size_t start = std::hash<std::thread::id>()(std::this_thread::get_id()) % MAX_READERS;
+
+    while (true) {
+        uint64_t epoch = m_globalEpoch.load(std::memory_order_seq_cst);
+
+        for (size_t i = 0; i < MAX_READERS; ++i) {
+            std::atomic<uint64_t>& record = m_readers[(start + i) % MAX_READERS].epoch;
+            uint64_t expected = IDLE;
+            if (record.compare_exchange_strong(expected, epoch, std::memory_order_seq_cst)) {
+                // Make the announcement visible before any pointer is read
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return Guard(&record);
+            }
+        }
+
+        // More concurrent readers than records - wait for one to unpin
+        std::this_thread::yield();
+    }
+}
+
+void EpochReclaimer::Retire(std::function<void()> deleter) {
+    std::lock_guard<std::mutex> lock(m_retiredMutex);
+    m_retired.push_back({m_globalEpoch.load(std::memory_order_seq_cst), std::move(deleter)});
+
+    // Readers pinning from now on can't reach the object
+    m_globalEpoch.fetch_add(1, std::memory_order_seq_cst);
+}
+
+size_t EpochReclaimer::Collect(size_t maxObjects) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Oldest epoch still pinned by a reader
+    uint64_t minEpoch = std::numeric_limits<uint64_t>::max();
+    for (const ReaderRecord& reader : m_readers) {
+        uint64_t epoch = reader.epoch.load(std::memory_order_seq_cst);
+        if (epoch != IDLE && epoch < minEpoch) {
+            minEpoch = epoch;
+        }
+    }
+
+    // Objects retired before that epoch are unreachable
+    std::vector<RetiredObject> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_retiredMutex);
+        auto keepEnd = std::partition(m_retired.begin(), m_retired.end(),
+            [minEpoch](const RetiredObject& object) { return object.epoch >= minEpoch; });
+
+        auto readyEnd = keepEnd + std::min<size_t>(maxObjects, m_retired.end() - keepEnd);
+        ready.assign(std::make_move_iterator(keepEnd), std::make_move_iterator(readyEnd));
+        m_retired.erase(keepEnd, readyEnd);
+    }
+
+    // Run deleters outside the lock; they may retire more objects
+    for (RetiredObject& object : ready) {
+        object.deleter();
+    }
+
+    return ready.size();
+}
+
+void EpochReclaimer::CollectAll() {
+    std::vector<RetiredObject> all;
+    {
+        std::lock_guard<std::mutex> lock(m_retiredMutex);
+        all.swap(m_retired);
+    }
+
+    for (RetiredObject& object : all) {
+        object.deleter();
+    }
+}
+
+size_t EpochReclaimer::GetRetiredCount() const {
+    std::lock_guard<std::mutex> lock(m_retiredMutex);
+    return m_retired.size();
+}
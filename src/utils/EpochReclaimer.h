@@ -0,0 +1,93 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Epoch-based memory reclamation.
+// Readers pin the current epoch while they hold raw pointers into a shared
+// structure; writers unlink objects first and then Retire() them. Retired
+// objects are destroyed by Collect() once every reader that could still see
+// them has unpinned. Readers never wait for writers and vice versa.
+class EpochReclaimer {
+public:
+    static constexpr size_t MAX_READERS = 128;
+
+    // RAII pin. Pointers obtained while a guard is alive stay valid until it is released.
+    class Guard {
+    public:
+        Guard() = default;
+        explicit Guard(std::atomic<uint64_t>* record) : m_record(record) {}
+        ~Guard() { Release(); }
+
+        Guard(Guard&& other) noexcept : m_record(other.m_record) { other.m_record = nullptr; }
+        Guard& operator=(Guard&& other) noexcept {
+            if (this != &other) {
+                Release();
+                m_record = other.m_record;
+                other.m_record = nullptr;
+            }
+            return *this;
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        void Release() {
+            if (m_record) {
+                m_record->store(IDLE, std::memory_order_release);
+                m_record = nullptr;
+            }
+        }
+
+    private:
+        std::atomic<uint64_t>* m_record = nullptr;
+    };
+
+    EpochReclaimer();
+    ~EpochReclaimer();
+
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+    // Any thread. Lock-free: claims a free reader record for the current epoch.
+    Guard Pin();
+
+    // Any thread. The object must already be unreachable for new readers.
+    void Retire(std::function<void()> deleter);
+
+    // Runs up to maxObjects deleters that no pinned reader can observe anymore,
+    // the rest stay queued for the next call.
+    // Call from the thread that is allowed to run them (main thread for chunks).
+    size_t Collect(size_t maxObjects = SIZE_MAX);
+
+    // Runs every pending deleter. Only valid when no reader can be pinned.
+    void CollectAll();
+
+    size_t GetRetiredCount() const;
+
+private:
+    static constexpr uint64_t IDLE = 0;
+
+    struct alignas(64) ReaderRecord {
+        std::atomic<uint64_t> epoch{IDLE};
+    };
+
+    struct RetiredObject {
+        uint64_t epoch;
+        std::function<void()> deleter;
+    };
+
+    ReaderRecord m_readers[MAX_READERS];
+    std::atomic<uint64_t> m_globalEpoch{1};
+
+    mutable std::mutex m_retiredMutex;
+    std::vector<RetiredObject> m_retired;
+};
@@ -0,0 +1,97 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free multi-producer / single-consumer queue.
+// Based on Dmitry Vyukov's bounded queue: every cell carries a sequence number,
+// producers claim a cell with a CAS on the enqueue position, the single
+// consumer never needs an atomic read-modify-write.
+template<typename T>
+class MPSCQueue {
+public:
+    // Capacity is rounded up to a power of two
+    explicit MPSCQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        m_mask = size - 1;
+        m_cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    // Any thread. Returns false (and leaves value untouched) when the queue is full.
+    bool TryPush(T&& value) {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+        while (true) {
+            Cell& cell = m_cells[pos & m_mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Full
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only. Returns false when the queue is empty.
+    bool TryPop(T& value) {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell& cell = m_cells[pos & m_mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+        if (diff < 0) {
+            return false; // Empty (or the producer hasn't finished writing yet)
+        }
+
+        value = std::move(cell.value);
+        cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Approximate, for statistics only
+    size_t SizeApprox() const {
+        size_t enqueued = m_enqueuePos.load(std::memory_order_relaxed);
+        size_t dequeued = m_dequeuePos.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    size_t GetCapacity() const { return m_mask + 1; }
+    size_t GetMemoryUsage() const { return GetCapacity() * sizeof(Cell); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask = 0;
+
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<size_t> m_dequeuePos{0};
+};
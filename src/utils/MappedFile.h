@@ -0,0 +1,36 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file.
+// Pages are loaded by the OS on first touch and shared with the page cache.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    const uint8_t* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
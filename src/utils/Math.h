@@ -7,6 +7,7 @@
 #include <glm/glm.hpp>
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <random>
 
 namespace Math {
@@ -27,6 +28,18 @@ namespace Math {
         return std::max(min, std::min(max, value));
     }
 
+    // Integer division/modulo rounding towards negative infinity
+    // (world -> chunk coordinates without float round trips)
+    inline int FloorDiv(int a, int b) {
+        int q = a / b;
+        return ((a % b != 0) && ((a < 0) != (b < 0))) ? q - 1 : q;
+    }
+
+    inline int FloorMod(int a, int b) {
+        int r = a % b;
+        return (r != 0 && ((r < 0) != (b < 0))) ? r + b : r;
+    }
+
     // Smooth step
     inline float SmoothStep(float edge0, float edge1, float x) {
         x = Clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
@@ -67,6 +80,34 @@ namespace Math {
         }
     };
 
+    // Stateless positional RNG: the same (seed, position, salt) gives the same
+    // value on every thread and run, in any order. Use a different salt for
+    // each independent decision made at one position.
+    inline uint64_t Mix64(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    inline uint32_t Hash(uint32_t seed, const glm::ivec3& position, uint32_t salt = 0) {
+        uint64_t h = Mix64((static_cast<uint64_t>(seed) << 32) | salt);
+        h = Mix64(h ^ static_cast<uint32_t>(position.x));
+        h = Mix64(h ^ ((static_cast<uint64_t>(static_cast<uint32_t>(position.y)) << 32) |
+                       static_cast<uint32_t>(position.z)));
+        return static_cast<uint32_t>(h >> 32);
+    }
+
+    // Uniform in [0, 1)
+    inline float HashFloat(uint32_t seed, const glm::ivec3& position, uint32_t salt = 0) {
+        return (Hash(seed, position, salt) >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // Uniform in [min, max]
+    inline int HashRange(uint32_t seed, const glm::ivec3& position, uint32_t salt, int min, int max) {
+        uint32_t range = static_cast<uint32_t>(max - min) + 1;
+        return min + static_cast<int>((static_cast<uint64_t>(Hash(seed, position, salt)) * range) >> 32);
+    }
+
     // Distance functions
     inline float Distance(const glm::vec3& a, const glm::vec3& b) {
         return glm::length(b - a);
@@ -161,4 +202,24 @@ namespace Math {
     constexpr float DEG_TO_RAD = 0.01745329251f;
     constexpr float RAD_TO_DEG = 57.2957795131f;
 
-} // namespace Math
\ No newline at end of file
+} // namespace Math
+
+// Hash functions for glm integer vectors.
+// Large odd multipliers spread neighbouring grid coordinates over the whole
+// word instead of letting shifted XORs cancel out on axis-aligned grids.
+struct ivec3Hash {
+    std::size_t operator()(const glm::ivec3& v) const {
+        uint64_t h = static_cast<uint32_t>(v.x) * 0x9E3779B97F4A7C15ull;
+        h ^= static_cast<uint32_t>(v.y) * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+        h ^= static_cast<uint32_t>(v.z) * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+};
+
+struct ivec2Hash {
+    std::size_t operator()(const glm::ivec2& v) const {
+        uint64_t h = static_cast<uint32_t>(v.x) * 0x9E3779B97F4A7C15ull;
+        h ^= static_cast<uint32_t>(v.y) * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+};
\ No newline at end of file
@@ -0,0 +1,95 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "MemoryAccounting.h"
+#include <array>
+#include <atomic>
+#include <iomanip>
+
+namespace {
+    std::array<std::atomic<int64_t>, MemoryAccounting::CATEGORY_COUNT> s_current{};
+    std::array<std::atomic<int64_t>, MemoryAccounting::CATEGORY_COUNT> s_peak{};
+    std::atomic<int64_t> s_total{0};
+    std::atomic<int64_t> s_totalPeak{0};
+
+    void RaisePeak(std::atomic<int64_t>& peak, int64_t value) {
+        int64_t current = peak.load(std::memory_order_relaxed);
+        while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void Apply(size_t index, int64_t previous, int64_t value) {
+        RaisePeak(s_peak[index], value);
+        int64_t total = s_total.fetch_add(value - previous, std::memory_order_relaxed) + (value - previous);
+        RaisePeak(s_totalPeak, total);
+    }
+
+    double ToMB(int64_t bytes) {
+        return bytes / (1024.0 * 1024.0);
+    }
+}
+
+void MemoryAccounting::Add(MemoryCategory category, int64_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+    size_t index = static_cast<size_t>(category);
+    int64_t previous = s_current[index].fetch_add(bytes, std::memory_order_relaxed);
+    Apply(index, previous, previous + bytes);
+}
+
+void MemoryAccounting::Set(MemoryCategory category, int64_t bytes) {
+    size_t index = static_cast<size_t>(category);
+    int64_t previous = s_current[index].exchange(bytes, std::memory_order_relaxed);
+    Apply(index, previous, bytes);
+}
+
+int64_t MemoryAccounting::GetCurrent(MemoryCategory category) {
+    return s_current[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+int64_t MemoryAccounting::GetPeak(MemoryCategory category) {
+    return s_peak[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+int64_t MemoryAccounting::GetTotal() {
+    return s_total.load(std::memory_order_relaxed);
+}
+
+int64_t MemoryAccounting::GetTotalPeak() {
+    return s_totalPeak.load(std::memory_order_relaxed);
+}
+
+const char* MemoryAccounting::GetCategoryName(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::VoxelData:        return "Voxel data";
+        case MemoryCategory::CompressedData:   return "Compressed chunks";
+        case MemoryCategory::MeshScratch:      return "Mesh scratch";
+        case MemoryCategory::GpuVertexBuffers: return "GPU vertex buffers";
+        case MemoryCategory::GpuIndexBuffers:  return "GPU index buffers";
+        case MemoryCategory::Textures:         return "Textures";
+        case MemoryCategory::Queues:           return "Queues";
+        case MemoryCategory::GeneratorCaches:  return "Generator caches";
+        default:                               return "Unknown";
+    }
+}
+
+void MemoryAccounting::Dump(std::ostream& out) {
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(2);
+
+    out << "=== Memory (current / peak MB) ===" << std::endl;
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        MemoryCategory category = static_cast<MemoryCategory>(i);
+        out << std::left << std::setw(20) << GetCategoryName(category) << std::right
+            << std::setw(10) << ToMB(GetCurrent(category)) << " / "
+            << ToMB(GetPeak(category)) << std::endl;
+    }
+    out << std::left << std::setw(20) << "Total" << std::right
+        << std::setw(10) << ToMB(GetTotal()) << " / " << ToMB(GetTotalPeak()) << std::endl;
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,43 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+enum class MemoryCategory : uint8_t {
+    VoxelData,        // Chunk objects: block indices, palette and bookkeeping
+    CompressedData,   // ChunkCodec encoded chunks of the compressed tier
+    MeshScratch,      // CPU vertex/index buffers reused while meshing
+    GpuVertexBuffers,
+    GpuIndexBuffers,
+    Textures,
+    Queues,           // Generation, column and storage queues with their maps
+    GeneratorCaches,  // World generator column samples
+    Count
+};
+
+// Process-wide byte counters per category, with high-water marks.
+// Allocation sites report deltas through Add(); categories that are cheaper
+// to measure than to track at every push (queues) are sampled through Set().
+// Thread safe, counters are relaxed atomics.
+class MemoryAccounting {
+public:
+    static constexpr size_t CATEGORY_COUNT = static_cast<size_t>(MemoryCategory::Count);
+
+    static void Add(MemoryCategory category, int64_t bytes);
+    static void Set(MemoryCategory category, int64_t bytes);
+
+    static int64_t GetCurrent(MemoryCategory category);
+    static int64_t GetPeak(MemoryCategory category);
+    static int64_t GetTotal();
+    static int64_t GetTotalPeak();
+
+    static const char* GetCategoryName(MemoryCategory category);
+
+    // One line per category: current and peak
+    static void Dump(std::ostream& out);
+};
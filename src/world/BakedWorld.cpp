@@ -0,0 +1,222 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "BakedWorld.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <tuple>
+
+bool BakedWorld::Open(const std::string& path) {
+    Close();
+
+    if (!m_file.Open(path)) {
+        return false;
+    }
+
+    if (m_file.GetSize() < sizeof(FileHeader)) {
+        std::cerr << "Baked world too small: " << path << std::endl;
+        Close();
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, m_file.GetData(), sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION ||
+        header.indexOffset % alignof(IndexEntry) != 0 ||
+        header.indexOffset + static_cast<uint64_t>(header.chunkCount) * sizeof(IndexEntry) > m_file.GetSize()) {
+        std::cerr << "Unsupported baked world: " << path << std::endl;
+        Close();
+        return false;
+    }
+
+    m_index = reinterpret_cast<const IndexEntry*>(m_file.GetData() + header.indexOffset);
+    m_chunkCount = header.chunkCount;
+    m_minChunk = glm::ivec3(header.minChunk[0], header.minChunk[1], header.minChunk[2]);
+    m_maxChunk = glm::ivec3(header.maxChunk[0], header.maxChunk[1], header.maxChunk[2]);
+
+    // Only the index is touched here; block pages fault in as chunks stream
+    if (!ValidateIndex()) {
+        std::cerr << "Corrupt baked world index: " << path << std::endl;
+        Close();
+        return false;
+    }
+
+    std::cout << "Baked world opened: " << path << " (" << m_chunkCount << " chunks, "
+              << m_file.GetSize() / 1024 << " KB mapped)" << std::endl;
+    return true;
+}
+
+void BakedWorld::Close() {
+    m_file.Close();
+    m_index = nullptr;
+    m_chunkCount = 0;
+}
+
+bool BakedWorld::ValidateIndex() const {
+    const uint64_t fileSize = m_file.GetSize();
+
+    for (size_t i = 0; i < m_chunkCount; ++i) {
+        const IndexEntry& entry = m_index[i];
+
+        if (entry.paletteSize == 0 || entry.paletteSize > Chunk::MAX_PALETTE_SIZE ||
+            entry.paletteOffset + entry.paletteSize > fileSize) {
+            return false;
+        }
+
+        if (entry.blocksOffset != 0 &&
+            (entry.blocksOffset % BLOCK_ALIGNMENT != 0 || entry.blocksOffset + Chunk::TOTAL_BLOCKS > fileSize)) {
+            return false;
+        }
+
+        // Binary search relies on the order
+        if (i > 0 && !LessPosition(m_index[i - 1], glm::ivec3(entry.x, entry.y, entry.z))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BakedWorld::LessPosition(const IndexEntry& entry, const glm::ivec3& position) {
+    return std::tie(entry.x, entry.y, entry.z) < std::tie(position.x, position.y, position.z);
+}
+
+bool BakedWorld::LoadChunk(Chunk& chunk) const {
+    const glm::ivec3& position = chunk.GetPosition();
+
+    const IndexEntry* end = m_index + m_chunkCount;
+    const IndexEntry* entry = std::lower_bound(m_index, end, position, LessPosition);
+    if (entry == end || entry->x != position.x || entry->y != position.y || entry->z != position.z) {
+        return false;
+    }
+
+    const uint8_t* data = m_file.GetData();
+    const BlockType* palette = reinterpret_cast<const BlockType*>(data + entry->paletteOffset);
+    const uint8_t* indices = entry->blocksOffset ? data + entry->blocksOffset : nullptr;
+    return chunk.ReferenceBlockData(palette, entry->paletteSize, indices);
+}
+
+void BakedWorld::Writer::AddChunk(const Chunk& chunk) {
+    const std::vector<BlockType>& palette = chunk.GetPalette();
+    const uint8_t* indices = chunk.GetBlockIndices();
+
+    // Drop palette entries no block uses (the generator may leave some behind)
+    std::vector<bool> used(palette.size(), false);
+    for (int i = 0; i < Chunk::TOTAL_BLOCKS; ++i) {
+        if (indices[i] < palette.size()) {
+            used[indices[i]] = true;
+        }
+    }
+
+    BakedChunk baked;
+    baked.position = chunk.GetPosition();
+
+    std::vector<uint8_t> remapping(palette.size(), 0);
+    for (size_t i = 0; i < palette.size(); ++i) {
+        if (used[i]) {
+            remapping[i] = static_cast<uint8_t>(baked.palette.size());
+            baked.palette.push_back(palette[i]);
+        }
+    }
+
+    if (baked.palette.empty() || (baked.palette.size() == 1 && baked.palette[0] == BlockType::Air)) {
+        return; // Missing entries read as Air
+    }
+
+    if (baked.palette.size() > 1) {
+        baked.indices.resize(Chunk::TOTAL_BLOCKS);
+        for (int i = 0; i < Chunk::TOTAL_BLOCKS; ++i) {
+            baked.indices[i] = indices[i] < palette.size() ? remapping[indices[i]] : 0;
+        }
+    }
+
+    m_chunks.push_back(std::move(baked));
+}
+
+bool BakedWorld::Writer::Write(const std::string& path) const {
+    std::vector<const BakedChunk*> sorted;
+    sorted.reserve(m_chunks.size());
+    for (const BakedChunk& chunk : m_chunks) {
+        sorted.push_back(&chunk);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const BakedChunk* a, const BakedChunk* b) {
+        return std::tie(a->position.x, a->position.y, a->position.z) <
+               std::tie(b->position.x, b->position.y, b->position.z);
+    });
+
+    auto alignUp = [](uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    };
+
+    FileHeader header{};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.chunkCount = static_cast<uint32_t>(sorted.size());
+    header.indexOffset = sizeof(FileHeader);
+
+    glm::ivec3 minChunk(0);
+    glm::ivec3 maxChunk(0);
+    if (!sorted.empty()) {
+        minChunk = maxChunk = sorted.front()->position;
+        for (const BakedChunk* chunk : sorted) {
+            minChunk = glm::min(minChunk, chunk->position);
+            maxChunk = glm::max(maxChunk, chunk->position);
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        header.minChunk[i] = minChunk[i];
+        header.maxChunk[i] = maxChunk[i];
+    }
+
+    // Palettes are packed right after the index, block data follows aligned
+    std::vector<IndexEntry> index(sorted.size());
+    uint64_t offset = header.indexOffset + index.size() * sizeof(IndexEntry);
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        index[i] = {};
+        index[i].x = sorted[i]->position.x;
+        index[i].y = sorted[i]->position.y;
+        index[i].z = sorted[i]->position.z;
+        index[i].paletteSize = static_cast<uint16_t>(sorted[i]->palette.size());
+        index[i].paletteOffset = offset;
+        offset += sorted[i]->palette.size();
+    }
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        if (!sorted[i]->indices.empty()) {
+            offset = alignUp(offset, BLOCK_ALIGNMENT);
+            index[i].blocksOffset = offset;
+            offset += Chunk::TOTAL_BLOCKS;
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Failed to create " << path << std::endl;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(IndexEntry));
+    for (const BakedChunk* chunk : sorted) {
+        file.write(reinterpret_cast<const char*>(chunk->palette.data()), chunk->palette.size());
+    }
+
+    static const char padding[BLOCK_ALIGNMENT] = {};
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        if (sorted[i]->indices.empty()) {
+            continue;
+        }
+        uint64_t position = static_cast<uint64_t>(file.tellp());
+        file.write(padding, static_cast<std::streamsize>(index[i].blocksOffset - position));
+        file.write(reinterpret_cast<const char*>(sorted[i]->indices.data()), Chunk::TOTAL_BLOCKS);
+    }
+
+    file.flush();
+    if (!file) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
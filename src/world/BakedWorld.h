@@ -0,0 +1,87 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "Chunk.h"
+#include "../utils/MappedFile.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Pre-generated, read-only world file (".vxb"), used instead of WorldGenerator.
+// Layout (native little-endian): header, index table sorted by (x, y, z),
+// then per chunk the palette and 8-bit block indices in Chunk's own storage
+// order. Block data is 64-byte aligned so chunks reference it in place
+// straight from the mapping. Uniform chunks store no block data; all-Air
+// chunks (and anything outside the baked bounds) aren't stored at all.
+class BakedWorld {
+public:
+    static constexpr uint32_t MAGIC = 0x42575856; // "VXWB"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_index != nullptr; }
+
+    // Any thread. Points the (reset) chunk at its baked data; chunks without
+    // an entry stay Air. Returns true when the chunk had baked data.
+    bool LoadChunk(Chunk& chunk) const;
+
+    size_t GetChunkCount() const { return m_chunkCount; }
+    const glm::ivec3& GetMinChunk() const { return m_minChunk; }
+    const glm::ivec3& GetMaxChunk() const { return m_maxChunk; }
+
+    // Builds a baked world file (used by the WorldBaker tool)
+    class Writer {
+    public:
+        // Copies the chunk's blocks with a compacted palette. All-Air chunks are skipped.
+        void AddChunk(const Chunk& chunk);
+        bool Write(const std::string& path) const;
+
+        size_t GetChunkCount() const { return m_chunks.size(); }
+
+    private:
+        struct BakedChunk {
+            glm::ivec3 position;
+            std::vector<BlockType> palette;
+            std::vector<uint8_t> indices; // Empty for uniform chunks
+        };
+
+        std::vector<BakedChunk> m_chunks;
+    };
+
+private:
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t chunkCount;
+        uint32_t reserved;
+        int32_t minChunk[3];
+        int32_t maxChunk[3];
+        uint64_t indexOffset;
+    };
+
+    struct IndexEntry {
+        int32_t x, y, z;
+        uint16_t paletteSize;
+        uint16_t reserved;
+        uint64_t paletteOffset;
+        uint64_t blocksOffset; // 0 for uniform chunks
+    };
+
+    static_assert(sizeof(FileHeader) == 48, "Baked world header layout changed");
+    static_assert(sizeof(IndexEntry) == 32, "Baked world index layout changed");
+
+    static bool LessPosition(const IndexEntry& entry, const glm::ivec3& position);
+    bool ValidateIndex() const;
+
+    MappedFile m_file;
+    const IndexEntry* m_index = nullptr;
+    size_t m_chunkCount = 0;
+    glm::ivec3 m_minChunk{0};
+    glm::ivec3 m_maxChunk{0};
+};
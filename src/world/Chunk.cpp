@@ -3,28 +3,157 @@
 //
 
 #include "Chunk.h"
-#include "../rendering/OpenGLUtils.h"
+#include "MeshUploader.h"
+#include "../utils/EpochReclaimer.h"
+#include "../utils/MemoryAccounting.h"
 #include <algorithm>
+#include <cstring>
 #include <unordered_map>
 
+namespace {
+    // Shared backing for uniform chunks referenced without block data
+    const std::array<uint8_t, Chunk::TOTAL_BLOCKS> s_uniformBlocks{};
+
+    void AccountMeshBuffers(const Chunk::MeshHandle& mesh, int64_t sign) {
+        MemoryAccounting::Add(MemoryCategory::GpuVertexBuffers, sign * static_cast<int64_t>(mesh.vertexCapacity));
+        MemoryAccounting::Add(MemoryCategory::GpuIndexBuffers, sign * static_cast<int64_t>(mesh.indexCapacity));
+    }
+}
+
 Chunk::Chunk(const glm::ivec3& position)
     : m_position(position)
     , m_worldPosition(position.x * SIZE, position.y * HEIGHT, position.z * SIZE) {
 
-    // Initialize palette with Air
-    m_palette.push_back(BlockType::Air);
+    // Initialize palette with Air. Reserving the maximum size up front keeps
+    // generation free of palette reallocations, also across pool reuse.
+    m_ownData.palette.reserve(MAX_PALETTE_SIZE);
+    m_ownData.palette.push_back(BlockType::Air);
 
     // Initialize all blocks as Air (index 0)
-    std::fill(m_blocks.begin(), m_blocks.end(), 0);
+    std::fill(m_ownData.blocks.begin(), m_ownData.blocks.end(), 0);
+
+    SetStateTime(ChunkState::Generating, std::chrono::steady_clock::now());
+    MemoryAccounting::Add(MemoryCategory::VoxelData, GetMemoryUsage());
 
-    // DON'T create OpenGL objects here - this runs in background thread!
-    // OpenGL objects will be created later in main thread
+    // DON'T create GPU objects here - this runs in background thread!
+    // They are created by the first mesh upload in main thread
+}
+
+void Chunk::Reset(const glm::ivec3& position) {
+    m_position = position;
+    m_worldPosition = glm::vec3(position.x * SIZE, position.y * HEIGHT, position.z * SIZE);
+
+    // Unpublished again - no reader can see the previous data anymore
+    FreeCopy();
+    m_reclaimer = nullptr;
+    m_ownData.palette.clear(); // Keeps the reserved capacity
+    m_ownData.palette.push_back(BlockType::Air);
+    std::fill(m_ownData.blocks.begin(), m_ownData.blocks.end(), 0);
+    m_ownData.indices = m_ownData.blocks.data();
+
+    m_indexCount = 0;
+    m_meshDirty = true;
+    m_meshReleased = false;
+    m_isEmpty = true;
+    m_modified = false;
+    m_visibleIndex = -1;
+    m_outOfRangeTime = -1.0f;
+    m_neighbors.fill(nullptr);
+
+    m_state.store(ChunkState::Generating, std::memory_order_relaxed);
+    m_stateTimes.fill(TimePoint());
+    SetStateTime(ChunkState::Generating, std::chrono::steady_clock::now());
+}
+
+bool Chunk::LoadBlockData(const std::vector<BlockType>& palette, const std::array<uint8_t, TOTAL_BLOCKS>& indices) {
+    if (palette.empty() || palette.size() > MAX_PALETTE_SIZE) {
+        return false;
+    }
+
+    BlockData& data = BeginWrite();
+    data.palette.assign(palette.begin(), palette.end()); // Fits the reserved capacity
+    data.blocks = indices;
+    EndWrite(data);
+    m_meshDirty = true;
+    return true;
+}
+
+bool Chunk::ReferenceBlockData(const BlockType* palette, size_t paletteSize, const uint8_t* indices) {
+    if (paletteSize == 0 || paletteSize > MAX_PALETTE_SIZE) {
+        return false;
+    }
+
+    // The palette is tiny, copying it keeps GetPaletteIndex() unchanged
+    BlockData& data = BeginWrite();
+    data.palette.assign(palette, palette + paletteSize);
+    data.indices = indices ? indices : s_uniformBlocks.data();
+    EndWrite(data);
+    m_meshDirty = true;
+    return true;
+}
+
+void Chunk::Fill(BlockType type) {
+    BlockData& data = BeginWrite();
+    data.palette.clear(); // Keeps the reserved capacity
+    data.palette.push_back(type);
+    data.indices = s_uniformBlocks.data();
+    EndWrite(data);
+    m_meshDirty = true;
+}
+
+Chunk::BlockData& Chunk::BeginWrite() {
+    BlockData* current = m_data.load(std::memory_order_relaxed);
+
+    if (!m_reclaimer) {
+        // Nobody else reads the chunk yet - write in place, copy on first write
+        if (current->IsShared()) {
+            std::memcpy(current->blocks.data(), current->indices, TOTAL_BLOCKS);
+            current->indices = current->blocks.data();
+        }
+        return *current;
+    }
+
+    auto* copy = new BlockData();
+    copy->palette.reserve(current->palette.size() + 1); // Room for the type being written
+    copy->palette = current->palette;
+    std::memcpy(copy->blocks.data(), current->indices, TOTAL_BLOCKS);
+    return *copy;
+}
+
+void Chunk::EndWrite(BlockData& data) {
+    BlockData* previous = m_data.load(std::memory_order_relaxed);
+    if (&data == previous) {
+        return;
+    }
+
+    MemoryAccounting::Add(MemoryCategory::VoxelData, static_cast<int64_t>(data.GetCopyBytes()));
+    m_data.store(&data, std::memory_order_release);
+
+    // m_ownData is simply left alone until Reset(); copies go once readers are done
+    if (previous != &m_ownData) {
+        m_reclaimer->Retire([previous] {
+            MemoryAccounting::Add(MemoryCategory::VoxelData, -static_cast<int64_t>(previous->GetCopyBytes()));
+            delete previous;
+        });
+    }
+}
+
+void Chunk::FreeCopy() {
+    BlockData* current = m_data.load(std::memory_order_relaxed);
+    if (current != &m_ownData) {
+        MemoryAccounting::Add(MemoryCategory::VoxelData, -static_cast<int64_t>(current->GetCopyBytes()));
+        delete current;
+        m_data.store(&m_ownData, std::memory_order_relaxed);
+    }
 }
 
 Chunk::~Chunk() {
-    if (m_vao) glDeleteVertexArrays(1, &m_vao);
-    if (m_vbo) glDeleteBuffers(1, &m_vbo);
-    if (m_ebo) glDeleteBuffers(1, &m_ebo);
+    if (m_meshUploader) {
+        AccountMeshBuffers(m_mesh, -1);
+        m_meshUploader->Release(m_mesh);
+    }
+    FreeCopy();
+    MemoryAccounting::Add(MemoryCategory::VoxelData, -static_cast<int64_t>(GetMemoryUsage()));
 }
 
 BlockType Chunk::GetBlock(int x, int y, int z) const {
@@ -32,12 +161,46 @@ BlockType Chunk::GetBlock(int x, int y, int z) const {
         return BlockType::Air;
     }
 
-    uint8_t paletteIndex = m_blocks[GetBlockIndex(x, y, z)];
-    if (paletteIndex >= m_palette.size()) {
+    const BlockData& data = GetData();
+    uint8_t paletteIndex = data.indices[GetBlockIndex(x, y, z)];
+    if (paletteIndex >= data.palette.size()) {
         return BlockType::Air;
     }
 
-    return m_palette[paletteIndex];
+    return data.palette[paletteIndex];
+}
+
+void Chunk::CopyBlocks(const glm::ivec3& localMin, const glm::ivec3& localMax,
+                       BlockType* out, size_t rowStride, size_t layerStride) const {
+    const int rowLength = localMax.x - localMin.x + 1;
+    const BlockData& data = GetData();
+
+    // Uniform chunk (palette of one) - no need to look at the indices
+    if (data.palette.size() == 1) {
+        for (int y = localMin.y; y <= localMax.y; ++y) {
+            BlockType* layer = out + (y - localMin.y) * layerStride;
+            for (int z = localMin.z; z <= localMax.z; ++z) {
+                std::fill_n(layer + (z - localMin.z) * rowStride, rowLength, data.palette[0]);
+            }
+        }
+        return;
+    }
+
+    // Full 256-entry lookup so decoding is branchless; stale indices read as Air
+    BlockType lookup[MAX_PALETTE_SIZE];
+    std::fill(std::begin(lookup), std::end(lookup), BlockType::Air);
+    std::copy(data.palette.begin(), data.palette.end(), lookup);
+
+    for (int y = localMin.y; y <= localMax.y; ++y) {
+        BlockType* layer = out + (y - localMin.y) * layerStride;
+        for (int z = localMin.z; z <= localMax.z; ++z) {
+            const uint8_t* src = data.indices + GetBlockIndex(localMin.x, y, z);
+            BlockType* dst = layer + (z - localMin.z) * rowStride;
+            for (int i = 0; i < rowLength; ++i) {
+                dst[i] = lookup[src[i]];
+            }
+        }
+    }
 }
 
 void Chunk::SetBlock(int x, int y, int z, BlockType type) {
@@ -45,8 +208,9 @@ void Chunk::SetBlock(int x, int y, int z, BlockType type) {
         return;
     }
 
-    uint8_t paletteIndex = GetPaletteIndex(type);
-    m_blocks[GetBlockIndex(x, y, z)] = paletteIndex;
+    BlockData& data = BeginWrite();
+    data.blocks[GetBlockIndex(x, y, z)] = GetPaletteIndex(data, type);
+    EndWrite(data);
     m_meshDirty = true;
 
     // Mark neighbor chunks dirty if block is on boundary
@@ -58,18 +222,18 @@ void Chunk::SetBlock(int x, int y, int z, BlockType type) {
     if (z == SIZE - 1 && m_neighbors[5]) m_neighbors[5]->MarkDirty();
 }
 
-uint8_t Chunk::GetPaletteIndex(BlockType type) {
+uint8_t Chunk::GetPaletteIndex(BlockData& data, BlockType type) {
     // Find existing palette entry
-    for (size_t i = 0; i < m_palette.size(); ++i) {
-        if (m_palette[i] == type) {
+    for (size_t i = 0; i < data.palette.size(); ++i) {
+        if (data.palette[i] == type) {
             return static_cast<uint8_t>(i);
         }
     }
 
     // Add new entry to palette
-    if (m_palette.size() < 255) { // Reserve 255 for special cases
-        m_palette.push_back(type);
-        return static_cast<uint8_t>(m_palette.size() - 1);
+    if (data.palette.size() < MAX_PALETTE_SIZE - 1) { // Reserve 255 for special cases
+        data.palette.push_back(type);
+        return static_cast<uint8_t>(data.palette.size() - 1);
     }
 
     // Palette full, return Air index (should rarely happen)
@@ -77,30 +241,32 @@ uint8_t Chunk::GetPaletteIndex(BlockType type) {
 }
 
 void Chunk::OptimizePalette() {
+    BlockData& data = BeginWrite();
+
     // Count usage of each palette entry
-    std::vector<uint32_t> usage(m_palette.size(), 0);
+    std::vector<uint32_t> usage(data.palette.size(), 0);
 
-    for (uint8_t blockIndex : m_blocks) {
+    for (uint8_t blockIndex : data.blocks) {
         if (blockIndex < usage.size()) {
             usage[blockIndex]++;
         }
     }
 
-    // Build new palette without unused entries
-    std::vector<BlockType> newPalette;
-    std::vector<uint8_t> remapping(m_palette.size());
+    // Compact the palette in place (no reallocation, see constructor)
+    std::vector<uint8_t> remapping(data.palette.size());
+    size_t newSize = 0;
 
-    for (size_t i = 0; i < m_palette.size(); ++i) {
+    for (size_t i = 0; i < data.palette.size(); ++i) {
         if (usage[i] > 0) {
-            remapping[i] = static_cast<uint8_t>(newPalette.size());
-            newPalette.push_back(m_palette[i]);
+            remapping[i] = static_cast<uint8_t>(newSize);
+            data.palette[newSize++] = data.palette[i];
         } else {
             remapping[i] = 0; // Map to Air
         }
     }
 
     // Remap block indices
-    for (uint8_t& blockIndex : m_blocks) {
+    for (uint8_t& blockIndex : data.blocks) {
         if (blockIndex < remapping.size()) {
             blockIndex = remapping[blockIndex];
         } else {
@@ -108,28 +274,20 @@ void Chunk::OptimizePalette() {
         }
     }
 
-    m_palette = std::move(newPalette);
-}
-
-void Chunk::CreateOpenGLObjects() {
-    if (m_vao == 0) {
-        m_vao = CreateVertexArray();
-        glGenBuffers(1, &m_vbo);
-        glGenBuffers(1, &m_ebo);
-        CheckGLError("Chunk OpenGL objects creation");
-    }
+    data.palette.resize(newSize);
+    EndWrite(data);
 }
 
-void Chunk::GenerateMesh() {
+void Chunk::GenerateMesh(MeshUploader& uploader) {
     if (!m_meshDirty) {
         return;
     }
 
-    // Create OpenGL objects if not created yet (main thread only!)
-    CreateOpenGLObjects();
-
-    std::vector<Vertex> vertices;
-    std::vector<uint32_t> indices;
+    // Scratch buffers keep their capacity between meshes (meshing runs on one thread)
+    static thread_local std::vector<Vertex> vertices;
+    static thread_local std::vector<uint32_t> indices;
+    vertices.clear();
+    indices.clear();
     m_isEmpty = true;
 
     // Generate geometry for each block
@@ -146,50 +304,37 @@ void Chunk::GenerateMesh() {
     }
 
     m_indexCount = indices.size();
+    m_meshReleased = false;
+
+    // Scratch capacity only grows; report the growth of this thread's buffers
+    static thread_local size_t scratchBytes = 0;
+    size_t newScratchBytes = vertices.capacity() * sizeof(Vertex) + indices.capacity() * sizeof(uint32_t);
+    MemoryAccounting::Add(MemoryCategory::MeshScratch, static_cast<int64_t>(newScratchBytes - scratchBytes));
+    scratchBytes = newScratchBytes;
 
     if (m_indexCount > 0) {
-        UpdateOpenGLBuffers(vertices, indices);
+        m_meshUploader = &uploader;
+        AccountMeshBuffers(m_mesh, -1);
+        uploader.Upload(m_mesh, vertices, indices);
+        AccountMeshBuffers(m_mesh, 1);
     }
 
     m_meshDirty = false;
 
-    // Optimize palette after major changes
-    if (m_palette.size() > 16) {
+    // Optimize palette after major changes (referenced data is already compact)
+    if (GetPaletteSize() > 16 && !IsBlockDataShared()) {
         OptimizePalette();
     }
 }
 
-void Chunk::UpdateOpenGLBuffers(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
-    glBindVertexArray(m_vao);
-
-    // Update vertex buffer
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
-
-    // Update index buffer
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
-
-    // Set up vertex attributes
-    // Position
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-
-    // Normal
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-
-    // Texture coordinates
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
-
-    // Texture index
-    glEnableVertexAttribArray(3);
-    glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(Vertex), (void*)offsetof(Vertex, textureIndex));
-
-    glBindVertexArray(0);
-
-    CheckGLError("Chunk mesh update");
+void Chunk::ReleaseMesh() {
+    if (m_meshUploader) {
+        AccountMeshBuffers(m_mesh, -1);
+        m_meshUploader->Release(m_mesh);
+    }
+    m_indexCount = 0;
+    m_meshDirty = true;
+    m_meshReleased = true;
 }
 
 void Chunk::SetNeighbor(int direction, Chunk* neighbor) {
@@ -202,10 +347,6 @@ bool Chunk::IsValidPosition(int x, int y, int z) const {
     return x >= 0 && x < SIZE && y >= 0 && y < HEIGHT && z >= 0 && z < SIZE;
 }
 
-int Chunk::GetBlockIndex(int x, int y, int z) const {
-    return y * SIZE * SIZE + z * SIZE + x;
-}
-
 bool Chunk::ShouldRenderFace(int x, int y, int z, int nx, int ny, int nz) const {
     // Check neighbor block in same chunk
     if (IsValidPosition(nx, ny, nz)) {
@@ -329,7 +470,13 @@ void Chunk::AddBlockFaces(int x, int y, int z, BlockType type,
 }
 
 size_t Chunk::GetMemoryUsage() const {
-    size_t paletteSize = m_palette.size() * sizeof(BlockType);
-    size_t blocksSize = m_blocks.size() * sizeof(uint8_t);
-    return paletteSize + blocksSize;
+    // The block array lives inside the object whether or not the chunk references
+    // shared data; the palette keeps its reserved capacity for the chunk's lifetime
+    size_t bytes = sizeof(Chunk) + m_ownData.palette.capacity() * sizeof(BlockType);
+
+    const BlockData& data = GetData();
+    if (&data != &m_ownData) {
+        bytes += data.GetCopyBytes();
+    }
+    return bytes;
 }
\ No newline at end of file
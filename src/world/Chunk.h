@@ -8,13 +8,32 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
 
+// Where a chunk is on its way from request to screen. Transitions go
+// through ChunkLifecycle, which times every stage.
+enum class ChunkState : uint8_t {
+    Requested,  // Position queued, no block data yet
+    Generating, // Generated or loaded on a worker / the I/O thread
+    Generated,  // Waiting for the main thread
+    Meshing,    // In the grid, first mesh pending
+    Uploaded,   // Mesh on the GPU, outside render distance or empty
+    Visible,    // In the visible set
+    Unloading,  // Out of the grid, waiting for readers before reuse
+    Count
+};
+
+class MeshUploader;
+class EpochReclaimer;
+
 class Chunk {
 public:
     static constexpr int SIZE = 16;
     static constexpr int HEIGHT = 16;
     static constexpr int TOTAL_BLOCKS = SIZE * SIZE * HEIGHT;
+    static constexpr size_t MAX_PALETTE_SIZE = 256;
 
     struct Vertex {
         glm::vec3 position;
@@ -23,25 +42,59 @@ public:
         uint32_t textureIndex;
     };
 
+    // GPU objects behind a chunk's mesh, owned by a MeshUploader
+    struct MeshHandle {
+        uint32_t vao = 0;
+        uint32_t vbo = 0;
+        uint32_t ebo = 0;
+        size_t vertexCapacity = 0; // Bytes allocated in vbo
+        size_t indexCapacity = 0;  // Bytes allocated in ebo
+    };
+
     Chunk(const glm::ivec3& position);
     ~Chunk();
 
-    // Block access using palette
+    // Returns the chunk to its freshly constructed state at a new position.
+    // GPU objects and buffer capacity are kept for reuse (see ChunkPool).
+    void Reset(const glm::ivec3& position);
+
+    // Block access using palette. Reads are safe from other threads while the
+    // chunk is published (see SetReclaimer) and the reader holds an epoch guard.
     BlockType GetBlock(int x, int y, int z) const;
     void SetBlock(int x, int y, int z, BlockType type);
-
-    // Mesh generation
-    void GenerateMesh();
-    void CreateOpenGLObjects(); // Create VAO/VBO/EBO (main thread only!)
+    // Every block becomes type in O(1): the chunk references shared uniform
+    // indices until its first SetBlock makes a private copy
+    void Fill(BlockType type);
+
+    // No position check - for hot loops that already clamp to the chunk
+    BlockType GetBlockUnchecked(int x, int y, int z) const {
+        const BlockData& data = GetData();
+        uint8_t paletteIndex = data.indices[GetBlockIndex(x, y, z)];
+        return paletteIndex < data.palette.size() ? data.palette[paletteIndex] : BlockType::Air;
+    }
+
+    // Decodes the local box [localMin, localMax] (inclusive) into out.
+    // Rows along X are contiguous; rowStride/layerStride are the distances
+    // (in elements) between consecutive Z rows and Y layers in out.
+    void CopyBlocks(const glm::ivec3& localMin, const glm::ivec3& localMax,
+                    BlockType* out, size_t rowStride, size_t layerStride) const;
+
+    // Mesh generation (main thread only). The uploader must outlive the
+    // chunk, which hands its GPU objects back to it when destroyed.
+    void GenerateMesh(MeshUploader& uploader);
+    // Frees the GPU mesh but keeps the blocks; the chunk stays dirty until re-meshed
+    void ReleaseMesh();
+    bool IsMeshReleased() const { return m_meshReleased; }
+    size_t GetMeshMemoryUsage() const { return m_mesh.vertexCapacity + m_mesh.indexCapacity; }
     bool NeedsMeshUpdate() const { return m_meshDirty; }
     void MarkDirty() { m_meshDirty = true; }
 
     // Getters
     const glm::ivec3& GetPosition() const { return m_position; }
     const glm::vec3& GetWorldPosition() const { return m_worldPosition; }
-    uint32_t GetVAO() const { return m_vao; }
-    uint32_t GetVBO() const { return m_vbo; }
-    uint32_t GetEBO() const { return m_ebo; }
+    uint32_t GetVAO() const { return m_mesh.vao; }
+    uint32_t GetVBO() const { return m_mesh.vbo; }
+    uint32_t GetEBO() const { return m_mesh.ebo; }
     uint32_t GetIndexCount() const { return m_indexCount; }
     bool IsEmpty() const { return m_isEmpty; }
 
@@ -49,40 +102,107 @@ public:
     void SetNeighbor(int direction, Chunk* neighbor);
     Chunk* GetNeighbor(int direction) const { return m_neighbors[direction]; }
 
+    // Position in ChunkManager's visible list, -1 when not in it
+    int GetVisibleIndex() const { return m_visibleIndex; }
+    void SetVisibleIndex(int index) { m_visibleIndex = index; }
+
+    // Time (ChunkManager clock) the chunk left unload range, negative while in range
+    float GetOutOfRangeTime() const { return m_outOfRangeTime; }
+    void SetOutOfRangeTime(float time) { m_outOfRangeTime = time; }
+
+    // Lifecycle state, changed with compare-and-swap (see ChunkLifecycle).
+    // Acquiring a chunk (constructor / Reset) starts it in Generating.
+    using TimePoint = std::chrono::steady_clock::time_point;
+    ChunkState GetState() const { return m_state.load(std::memory_order_acquire); }
+    bool CompareExchangeState(ChunkState& expected, ChunkState desired) {
+        return m_state.compare_exchange_strong(expected, desired, std::memory_order_acq_rel);
+    }
+    // When the chunk entered each state; default-constructed if it never did
+    TimePoint GetStateTime(ChunkState state) const { return m_stateTimes[static_cast<size_t>(state)]; }
+    void SetStateTime(ChunkState state, TimePoint time) { m_stateTimes[static_cast<size_t>(state)] = time; }
+
+    // Set when lock-free readers can reach the chunk (ChunkManager's grid).
+    // From then on every write builds new block data, swaps it in atomically
+    // and retires the old one through reclaimer. Reset() clears it.
+    void SetReclaimer(EpochReclaimer* reclaimer) { m_reclaimer = reclaimer; }
+
+    // Edited after generation/loading (needs saving)
+    bool IsModified() const { return m_modified; }
+    void SetModified(bool modified) { m_modified = modified; }
+
+    // Raw palette data for serialization (valid until the next write)
+    const std::vector<BlockType>& GetPalette() const { return GetData().palette; }
+    const uint8_t* GetBlockIndices() const { return GetData().indices; } // TOTAL_BLOCKS entries
+    bool LoadBlockData(const std::vector<BlockType>& palette, const std::array<uint8_t, TOTAL_BLOCKS>& indices);
+
+    // Zero-copy: reads go straight to 'indices' (e.g. a memory-mapped file,
+    // nullptr means every block uses palette entry 0). The memory must outlive
+    // the chunk or its next Reset(); a private copy is made on the first SetBlock.
+    bool ReferenceBlockData(const BlockType* palette, size_t paletteSize, const uint8_t* indices);
+    bool IsBlockDataShared() const { return GetData().IsShared(); }
+
     // Palette info for debugging
-    size_t GetPaletteSize() const { return m_palette.size(); }
-    size_t GetMemoryUsage() const;
+    size_t GetPaletteSize() const { return GetData().palette.size(); }
+    size_t GetMemoryUsage() const; // CPU side: the object itself, palette storage and a published copy
 
 private:
+    // Palette system for memory efficiency
+    struct BlockData {
+        std::vector<BlockType> palette;           // Unique block types in this chunk
+        std::array<uint8_t, TOTAL_BLOCKS> blocks; // Indices into palette (1 byte per block)
+        const uint8_t* indices = blocks.data();   // blocks or referenced external data
+
+        BlockData() = default;
+        BlockData(const BlockData&) = delete;
+        BlockData& operator=(const BlockData&) = delete;
+
+        bool IsShared() const { return indices != blocks.data(); }
+        size_t GetCopyBytes() const { return sizeof(BlockData) + palette.capacity() * sizeof(BlockType); }
+    };
+
+    const BlockData& GetData() const { return *m_data.load(std::memory_order_acquire); }
+    // The data a write goes to: the current one with private indices, or
+    // once published a private copy. EndWrite() swaps a copy in.
+    BlockData& BeginWrite();
+    void EndWrite(BlockData& data);
+    void FreeCopy();
+
     // Coordinate helpers
     bool IsValidPosition(int x, int y, int z) const;
-    int GetBlockIndex(int x, int y, int z) const;
+    static int GetBlockIndex(int x, int y, int z) { return y * SIZE * SIZE + z * SIZE + x; }
 
     // Palette management
-    uint8_t GetPaletteIndex(BlockType type);
+    static uint8_t GetPaletteIndex(BlockData& data, BlockType type);
     void OptimizePalette();
 
     // Mesh generation
     void AddBlockFaces(int x, int y, int z, BlockType type,
                       std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
     bool ShouldRenderFace(int x, int y, int z, int nx, int ny, int nz) const;
-    void UpdateOpenGLBuffers(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
 
     // Position
     glm::ivec3 m_position;
     glm::vec3 m_worldPosition;
 
-    // Palette system for memory efficiency
-    std::vector<BlockType> m_palette;           // Unique block types in this chunk
-    std::array<uint8_t, TOTAL_BLOCKS> m_blocks; // Indices into palette (1 byte per block)
+    // Block data. m_ownData until the first write after publishing, then a
+    // heap copy per write; readers see one or the other, never a mix.
+    BlockData m_ownData;
+    std::atomic<BlockData*> m_data{&m_ownData};
+    EpochReclaimer* m_reclaimer = nullptr;
 
-    // OpenGL buffers
-    uint32_t m_vao = 0;
-    uint32_t m_vbo = 0;
-    uint32_t m_ebo = 0;
+    // GPU mesh
+    MeshHandle m_mesh;
+    MeshUploader* m_meshUploader = nullptr; // Set by the first upload
     uint32_t m_indexCount = 0;
     bool m_meshDirty = true;
+    bool m_meshReleased = false;
     bool m_isEmpty = true;
+    bool m_modified = false;
+    int m_visibleIndex = -1;
+    float m_outOfRangeTime = -1.0f;
+
+    std::atomic<ChunkState> m_state{ChunkState::Generating};
+    std::array<TimePoint, static_cast<size_t>(ChunkState::Count)> m_stateTimes{};
 
     // Neighbors for optimization (6 directions: -X, +X, -Y, +Y, -Z, +Z)
     std::array<Chunk*, 6> m_neighbors = { nullptr };
@@ -0,0 +1,210 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "ChunkCodec.h"
+#include <algorithm>
+
+namespace {
+    constexpr size_t HEADER_SIZE = 16;
+    constexpr size_t MIN_RUN = 3;
+    constexpr size_t MAX_RUN = 130;
+    constexpr size_t MAX_LITERALS = 128;
+
+    void WriteU16(std::vector<uint8_t>& out, uint16_t value) {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+    void WriteU32(std::vector<uint8_t>& out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+        }
+    }
+
+    uint16_t ReadU16(const uint8_t* data) {
+        return static_cast<uint16_t>(data[0] | (data[1] << 8));
+    }
+
+    uint32_t ReadU32(const uint8_t* data) {
+        return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+               (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    std::array<uint32_t, 256> BuildCrcTable() {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+}
+
+void ChunkSnapshot::Capture(const Chunk& chunk) {
+    position = chunk.GetPosition();
+    palette = chunk.GetPalette();
+    std::copy_n(chunk.GetBlockIndices(), Chunk::TOTAL_BLOCKS, indices.begin());
+}
+
+uint32_t ChunkCodec::Crc32(const uint8_t* data, size_t size) {
+    static const std::array<uint32_t, 256> table = BuildCrcTable();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+int ChunkCodec::GetIndexBits(size_t paletteSize) {
+    if (paletteSize <= 1) return 0;
+    if (paletteSize <= 2) return 1;
+    if (paletteSize <= 4) return 2;
+    if (paletteSize <= 16) return 4;
+    return 8;
+}
+
+void ChunkCodec::Encode(const ChunkSnapshot& snapshot, std::vector<uint8_t>& out) {
+    const size_t paletteSize = snapshot.palette.size();
+    const int bits = GetIndexBits(paletteSize);
+
+    // Uncompressed payload: palette, then packed indices (LSB first)
+    thread_local std::vector<uint8_t> raw;
+    raw.clear();
+    for (BlockType type : snapshot.palette) {
+        raw.push_back(static_cast<uint8_t>(type));
+    }
+
+    if (bits > 0) {
+        const int perByte = 8 / bits;
+        const size_t packedSize = (Chunk::TOTAL_BLOCKS + perByte - 1) / perByte;
+        const size_t start = raw.size();
+        raw.resize(start + packedSize, 0);
+
+        for (int i = 0; i < Chunk::TOTAL_BLOCKS; ++i) {
+            raw[start + i / perByte] |= static_cast<uint8_t>(snapshot.indices[i] << ((i % perByte) * bits));
+        }
+    }
+
+    out.clear();
+    WriteU32(out, MAGIC);
+    out.push_back(VERSION);
+    out.push_back(static_cast<uint8_t>(bits));
+    WriteU16(out, static_cast<uint16_t>(paletteSize));
+    WriteU32(out, static_cast<uint32_t>(raw.size()));
+    WriteU32(out, Crc32(raw.data(), raw.size()));
+
+    CompressRLE(raw.data(), raw.size(), out);
+}
+
+bool ChunkCodec::Decode(const uint8_t* data, size_t size, ChunkSnapshot& snapshot) {
+    if (size < HEADER_SIZE || ReadU32(data) != MAGIC || data[4] != VERSION) {
+        return false;
+    }
+
+    const int bits = data[5];
+    const size_t paletteSize = ReadU16(data + 6);
+    const size_t rawSize = ReadU32(data + 8);
+    const uint32_t crc = ReadU32(data + 12);
+
+    if (paletteSize == 0 || paletteSize > Chunk::MAX_PALETTE_SIZE || bits != GetIndexBits(paletteSize)) {
+        return false;
+    }
+
+    const size_t packedSize = bits > 0 ? (Chunk::TOTAL_BLOCKS * bits + 7) / 8 : 0;
+    if (rawSize != paletteSize + packedSize) {
+        return false;
+    }
+
+    thread_local std::vector<uint8_t> raw;
+    if (!DecompressRLE(data + HEADER_SIZE, size - HEADER_SIZE, raw, rawSize) ||
+        Crc32(raw.data(), raw.size()) != crc) {
+        return false;
+    }
+
+    snapshot.palette.resize(paletteSize);
+    for (size_t i = 0; i < paletteSize; ++i) {
+        snapshot.palette[i] = static_cast<BlockType>(raw[i]);
+    }
+
+    if (bits == 0) {
+        snapshot.indices.fill(0);
+        return true;
+    }
+
+    const uint8_t* packed = raw.data() + paletteSize;
+    const int perByte = 8 / bits;
+    const uint8_t mask = static_cast<uint8_t>((1u << bits) - 1);
+
+    for (int i = 0; i < Chunk::TOTAL_BLOCKS; ++i) {
+        uint8_t index = (packed[i / perByte] >> ((i % perByte) * bits)) & mask;
+        if (index >= paletteSize) {
+            return false;
+        }
+        snapshot.indices[i] = index;
+    }
+
+    return true;
+}
+
+void ChunkCodec::CompressRLE(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    size_t i = 0;
+    while (i < size) {
+        // Length of the run starting at i
+        size_t run = 1;
+        while (i + run < size && run < MAX_RUN && data[i + run] == data[i]) {
+            run++;
+        }
+
+        if (run >= MIN_RUN) {
+            out.push_back(static_cast<uint8_t>(run + 125));
+            out.push_back(data[i]);
+            i += run;
+            continue;
+        }
+
+        // Collect literals until the next run worth encoding
+        size_t literalStart = i;
+        size_t literals = 0;
+        while (i < size && literals < MAX_LITERALS) {
+            if (i + 2 < size && data[i] == data[i + 1] && data[i] == data[i + 2]) {
+                break;
+            }
+            i++;
+            literals++;
+        }
+
+        out.push_back(static_cast<uint8_t>(literals - 1));
+        out.insert(out.end(), data + literalStart, data + literalStart + literals);
+    }
+}
+
+bool ChunkCodec::DecompressRLE(const uint8_t* data, size_t size, std::vector<uint8_t>& out, size_t expectedSize) {
+    out.clear();
+    out.reserve(expectedSize);
+
+    size_t i = 0;
+    while (i < size) {
+        uint8_t control = data[i++];
+        if (control < MAX_LITERALS) {
+            size_t count = static_cast<size_t>(control) + 1;
+            if (i + count > size || out.size() + count > expectedSize) {
+                return false;
+            }
+            out.insert(out.end(), data + i, data + i + count);
+            i += count;
+        } else {
+            size_t count = static_cast<size_t>(control) - 125;
+            if (i >= size || out.size() + count > expectedSize) {
+                return false;
+            }
+            out.insert(out.end(), count, data[i++]);
+        }
+    }
+
+    return out.size() == expectedSize;
+}
@@ -0,0 +1,46 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "Chunk.h"
+#include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Copy of a chunk's block data, safe to hand to another thread
+struct ChunkSnapshot {
+    glm::ivec3 position{0};
+    std::vector<BlockType> palette;
+    std::array<uint8_t, Chunk::TOTAL_BLOCKS> indices{};
+
+    void Capture(const Chunk& chunk);
+};
+
+// Versioned binary chunk format.
+// Payload: palette entries followed by block indices bit-packed to the
+// smallest width that fits the palette (0, 1, 2, 4 or 8 bits), RLE compressed.
+// The header carries a CRC32 of the uncompressed payload.
+class ChunkCodec {
+public:
+    static constexpr uint32_t MAGIC = 0x31435856; // "VXC1"
+    static constexpr uint8_t VERSION = 1;
+
+    static void Encode(const ChunkSnapshot& snapshot, std::vector<uint8_t>& out);
+
+    // Returns false on a corrupt, truncated or unknown-version record
+    static bool Decode(const uint8_t* data, size_t size, ChunkSnapshot& snapshot);
+
+    static uint32_t Crc32(const uint8_t* data, size_t size);
+
+private:
+    static int GetIndexBits(size_t paletteSize);
+
+    // PackBits-style RLE: control byte < 128 -> (n + 1) literals follow,
+    // otherwise the next byte repeats (n - 125) times
+    static void CompressRLE(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+    static bool DecompressRLE(const uint8_t* data, size_t size, std::vector<uint8_t>& out, size_t expectedSize);
+};
@@ -0,0 +1,113 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "ChunkGrid.h"
+#include <cstdlib>
+
+ChunkGrid::ChunkGrid(int horizontalRadius, int verticalRadius)
+    : m_radius(horizontalRadius, verticalRadius, horizontalRadius)
+    , m_size(m_radius * 2 + glm::ivec3(1))
+    , m_slots(static_cast<size_t>(m_size.x) * m_size.y * m_size.z) {
+
+    for (auto& slot : m_slots) {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ChunkGrid::~ChunkGrid() {
+    for (auto& slot : m_slots) {
+        delete slot.exchange(nullptr);
+    }
+}
+
+bool ChunkGrid::IsInside(const glm::ivec3& position) const {
+    glm::ivec3 offset = position - m_center;
+    return std::abs(offset.x) <= m_radius.x &&
+           std::abs(offset.y) <= m_radius.y &&
+           std::abs(offset.z) <= m_radius.z;
+}
+
+bool ChunkGrid::Insert(std::unique_ptr<Chunk>& chunk) {
+    const glm::ivec3& position = chunk->GetPosition();
+    if (!IsInside(position)) {
+        return false;
+    }
+
+    std::atomic<Chunk*>& slot = m_slots[GetSlotIndex(position)];
+    if (slot.load(std::memory_order_relaxed)) {
+        return false; // Already loaded
+    }
+
+    // Publish the fully constructed chunk to lock-free readers
+    slot.store(chunk.release(), std::memory_order_release);
+    m_count++;
+    return true;
+}
+
+std::unique_ptr<Chunk> ChunkGrid::Remove(const glm::ivec3& position) {
+    std::atomic<Chunk*>& slot = m_slots[GetSlotIndex(position)];
+    Chunk* chunk = slot.load(std::memory_order_relaxed);
+    if (!chunk || chunk->GetPosition() != position) {
+        return nullptr;
+    }
+
+    slot.store(nullptr, std::memory_order_release);
+    m_count--;
+    return std::unique_ptr<Chunk>(chunk);
+}
+
+void ChunkGrid::Recenter(const glm::ivec3& center, std::vector<std::unique_ptr<Chunk>>& evicted) {
+    glm::ivec3 oldCenter = m_center;
+    m_center = center;
+
+    for (int axis = 0; axis < 3; ++axis) {
+        int delta = center[axis] - oldCenter[axis];
+        if (delta == 0) {
+            continue;
+        }
+
+        // Coordinates on this axis that were inside the old window but not the new one
+        int first;
+        int last;
+        if (std::abs(delta) >= m_size[axis]) {
+            first = oldCenter[axis] - m_radius[axis];
+            last = oldCenter[axis] + m_radius[axis];
+        } else if (delta > 0) {
+            first = oldCenter[axis] - m_radius[axis];
+            last = first + delta - 1;
+        } else {
+            last = oldCenter[axis] + m_radius[axis];
+            first = last + delta + 1;
+        }
+
+        for (int value = first; value <= last; ++value) {
+            EvictSlab(axis, value, evicted);
+        }
+    }
+}
+
+void ChunkGrid::EvictSlab(int axis, int value, std::vector<std::unique_ptr<Chunk>>& evicted) {
+    int uAxis = (axis + 1) % 3;
+    int vAxis = (axis + 2) % 3;
+
+    glm::ivec3 position(0);
+    position[axis] = value;
+
+    // Any representative coordinates work for the other two axes: the slot
+    // index only depends on them modulo the window size
+    for (int u = 0; u < m_size[uAxis]; ++u) {
+        for (int v = 0; v < m_size[vAxis]; ++v) {
+            position[uAxis] = u;
+            position[vAxis] = v;
+
+            std::atomic<Chunk*>& slot = m_slots[GetSlotIndex(position)];
+            Chunk* chunk = slot.load(std::memory_order_relaxed);
+            if (chunk && !IsInside(chunk->GetPosition())) {
+                slot.store(nullptr, std::memory_order_release);
+                m_count--;
+                evicted.emplace_back(chunk);
+            }
+        }
+    }
+}
@@ -0,0 +1,79 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "Chunk.h"
+#include <glm/glm.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Dense window of chunks around the viewer.
+// A fixed 3D ring buffer indexed by chunk coordinates modulo the window size,
+// so a slot is reused (never moved) when the window recentres.
+// Lookups are a single atomic load; all mutation happens on the main thread.
+class ChunkGrid {
+public:
+    ChunkGrid(int horizontalRadius, int verticalRadius);
+    ~ChunkGrid();
+
+    ChunkGrid(const ChunkGrid&) = delete;
+    ChunkGrid& operator=(const ChunkGrid&) = delete;
+
+    // Lock-free lookup, returns nullptr if the chunk isn't loaded
+    Chunk* Get(const glm::ivec3& position) const {
+        Chunk* chunk = m_slots[GetSlotIndex(position)].load(std::memory_order_acquire);
+        return (chunk && chunk->GetPosition() == position) ? chunk : nullptr;
+    }
+
+    bool IsInside(const glm::ivec3& position) const;
+
+    // Main thread only. Insert takes ownership on success and leaves the
+    // pointer untouched when the position lies outside the window or is
+    // already loaded. Removed/evicted chunks may still be seen by concurrent
+    // readers - the caller decides when it is safe to free them.
+    bool Insert(std::unique_ptr<Chunk>& chunk);
+    std::unique_ptr<Chunk> Remove(const glm::ivec3& position);
+
+    // Moves the window. Chunks that fall outside are moved into 'evicted'.
+    // Only the slabs that left the window are visited.
+    void Recenter(const glm::ivec3& center, std::vector<std::unique_ptr<Chunk>>& evicted);
+
+    // Walks the slot array and calls func(Chunk*) for every loaded chunk
+    template<typename Func>
+    void ForEach(Func&& func) const {
+        for (const auto& slot : m_slots) {
+            Chunk* chunk = slot.load(std::memory_order_relaxed);
+            if (chunk) {
+                func(chunk);
+            }
+        }
+    }
+
+    const glm::ivec3& GetCenter() const { return m_center; }
+    const glm::ivec3& GetSize() const { return m_size; }
+    size_t GetCount() const { return m_count; }
+
+private:
+    static int WrapIndex(int value, int size) {
+        int result = value % size;
+        return result < 0 ? result + size : result;
+    }
+
+    size_t GetSlotIndex(const glm::ivec3& position) const {
+        return (static_cast<size_t>(WrapIndex(position.y, m_size.y)) * m_size.z +
+                static_cast<size_t>(WrapIndex(position.z, m_size.z))) * m_size.x +
+                static_cast<size_t>(WrapIndex(position.x, m_size.x));
+    }
+
+    // Evicts every chunk with coordinate 'value' on 'axis' that is outside the window
+    void EvictSlab(int axis, int value, std::vector<std::unique_ptr<Chunk>>& evicted);
+
+    glm::ivec3 m_radius;
+    glm::ivec3 m_size;
+    glm::ivec3 m_center{0};
+    std::vector<std::atomic<Chunk*>> m_slots;
+    size_t m_count = 0;
+};
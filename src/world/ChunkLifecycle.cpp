@@ -0,0 +1,140 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "ChunkLifecycle.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+void LatencyHistogram::Record(double seconds) {
+    uint64_t micros = static_cast<uint64_t>(std::max(seconds, 0.0) * 1e6);
+
+    int bucket = 0;
+    while (bucket < BUCKET_COUNT - 1 && (micros >> (bucket + 1)) != 0) {
+        bucket++;
+    }
+
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_totalMicros.fetch_add(micros, std::memory_order_relaxed);
+
+    uint64_t max = m_maxMicros.load(std::memory_order_relaxed);
+    while (micros > max && !m_maxMicros.compare_exchange_weak(max, micros, std::memory_order_relaxed)) {
+    }
+}
+
+double LatencyHistogram::GetMean() const {
+    uint64_t count = GetCount();
+    return count > 0 ? m_totalMicros.load(std::memory_order_relaxed) * 1e-6 / count : 0.0;
+}
+
+double LatencyHistogram::GetMax() const {
+    return m_maxMicros.load(std::memory_order_relaxed) * 1e-6;
+}
+
+double LatencyHistogram::GetPercentile(double fraction) const {
+    uint64_t count = GetCount();
+    if (count == 0) {
+        return 0.0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(std::ceil(fraction * count));
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            return std::min(static_cast<double>(uint64_t(1) << (i + 1)) * 1e-6, GetMax());
+        }
+    }
+    return GetMax();
+}
+
+bool ChunkLifecycle::Transition(Chunk& chunk, ChunkState from, ChunkState to) {
+    ChunkState expected = from;
+    if (!chunk.CompareExchangeState(expected, to)) {
+        return false;
+    }
+
+    RecordStage(chunk, from, to);
+    return true;
+}
+
+void ChunkLifecycle::RecordRequest(Chunk& chunk, Chunk::TimePoint requestTime) {
+    chunk.SetStateTime(ChunkState::Requested, requestTime);
+
+    std::chrono::duration<double> waited = chunk.GetStateTime(ChunkState::Generating) - requestTime;
+    m_stageLatency[static_cast<size_t>(ChunkState::Requested)].Record(waited.count());
+}
+
+void ChunkLifecycle::BeginUnload(Chunk& chunk) {
+    ChunkState current = chunk.GetState();
+    while (current != ChunkState::Unloading) {
+        ChunkState from = current;
+        if (chunk.CompareExchangeState(current, ChunkState::Unloading)) {
+            RecordStage(chunk, from, ChunkState::Unloading);
+            return;
+        }
+    }
+}
+
+void ChunkLifecycle::FinishUnload(Chunk& chunk) {
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - chunk.GetStateTime(ChunkState::Unloading);
+    m_stageLatency[static_cast<size_t>(ChunkState::Unloading)].Record(elapsed.count());
+}
+
+void ChunkLifecycle::RecordStage(Chunk& chunk, ChunkState from, ChunkState to) {
+    Chunk::TimePoint now = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double> elapsed = now - chunk.GetStateTime(from);
+    m_stageLatency[static_cast<size_t>(from)].Record(elapsed.count());
+
+    // Only the first time a requested chunk shows up counts towards time-to-visible
+    if (to == ChunkState::Visible && chunk.GetStateTime(ChunkState::Visible) == Chunk::TimePoint() &&
+        chunk.GetStateTime(ChunkState::Requested) != Chunk::TimePoint()) {
+        std::chrono::duration<double> total = now - chunk.GetStateTime(ChunkState::Requested);
+        m_timeToVisible.Record(total.count());
+    }
+
+    chunk.SetStateTime(to, now);
+}
+
+void ChunkLifecycle::Dump(std::ostream& out) const {
+    const std::streamsize precision = out.precision();
+    auto printRow = [&out](const char* name, const LatencyHistogram& histogram) {
+        out << "  " << std::left << std::setw(16) << name << std::right
+            << std::setw(8) << histogram.GetCount()
+            << std::fixed << std::setprecision(2)
+            << std::setw(10) << histogram.GetMean() * 1000.0
+            << std::setw(10) << histogram.GetPercentile(0.5) * 1000.0
+            << std::setw(10) << histogram.GetPercentile(0.95) * 1000.0
+            << std::setw(10) << histogram.GetPercentile(0.99) * 1000.0
+            << std::setw(10) << histogram.GetMax() * 1000.0 << "\n";
+    };
+
+    out << "Chunk lifecycle latency (ms):\n";
+    out << "  " << std::left << std::setw(16) << "stage" << std::right
+        << std::setw(8) << "count" << std::setw(10) << "mean" << std::setw(10) << "p50"
+        << std::setw(10) << "p95" << std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+
+    for (size_t i = 0; i < STATE_COUNT; ++i) {
+        printRow(GetStateName(static_cast<ChunkState>(i)), m_stageLatency[i]);
+    }
+    printRow("time-to-visible", m_timeToVisible);
+    out << std::defaultfloat;
+    out.precision(precision);
+}
+
+const char* ChunkLifecycle::GetStateName(ChunkState state) {
+    switch (state) {
+        case ChunkState::Requested: return "Requested";
+        case ChunkState::Generating: return "Generating";
+        case ChunkState::Generated: return "Generated";
+        case ChunkState::Meshing: return "Meshing";
+        case ChunkState::Uploaded: return "Uploaded";
+        case ChunkState::Visible: return "Visible";
+        case ChunkState::Unloading: return "Unloading";
+        default: return "Unknown";
+    }
+}
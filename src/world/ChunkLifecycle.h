@@ -0,0 +1,68 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "Chunk.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+// Lock-free latency histogram with power-of-two buckets:
+// bucket i counts samples in [2^i, 2^(i+1)) microseconds
+class LatencyHistogram {
+public:
+    static constexpr int BUCKET_COUNT = 27; // Up to ~2 minutes
+
+    void Record(double seconds);
+
+    uint64_t GetCount() const { return m_count.load(std::memory_order_relaxed); }
+    double GetMean() const;   // Seconds
+    double GetMax() const;    // Seconds
+    // Upper bound of the bucket holding the given fraction (0..1) of samples, in seconds
+    double GetPercentile(double fraction) const;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_totalMicros{0};
+    std::atomic<uint64_t> m_maxMicros{0};
+};
+
+// Moves chunks through ChunkState and times each stage.
+// Transitions are compare-and-swap on the chunk's state, so a chunk can't
+// skip a stage or enter one twice; a transition from the wrong state
+// changes nothing and returns false. Safe from any thread.
+class ChunkLifecycle {
+public:
+    static constexpr size_t STATE_COUNT = static_cast<size_t>(ChunkState::Count);
+
+    bool Transition(Chunk& chunk, ChunkState from, ChunkState to);
+
+    // The Requested stage ends before the chunk object exists: called on the
+    // main thread once the chunk arrives, with the time its position was queued
+    void RecordRequest(Chunk& chunk, Chunk::TimePoint requestTime);
+
+    // Any state -> Unloading, then the chunk is handed back to the pool
+    void BeginUnload(Chunk& chunk);
+    void FinishUnload(Chunk& chunk);
+
+    // Time spent in a stage, recorded when the chunk leaves it
+    const LatencyHistogram& GetStageLatency(ChunkState state) const {
+        return m_stageLatency[static_cast<size_t>(state)];
+    }
+    // Request until the chunk first entered the visible set
+    const LatencyHistogram& GetTimeToVisible() const { return m_timeToVisible; }
+
+    void Dump(std::ostream& out) const;
+
+    static const char* GetStateName(ChunkState state);
+
+private:
+    void RecordStage(Chunk& chunk, ChunkState from, ChunkState to);
+
+    std::array<LatencyHistogram, STATE_COUNT> m_stageLatency;
+    LatencyHistogram m_timeToVisible;
+};
@@ -3,28 +3,48 @@
 //
 
 #include "ChunkManager.h"
+#include "../utils/MemoryAccounting.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <queue>
+#include <thread>
 
-ChunkManager::ChunkManager() {
+ChunkManager::ChunkManager(std::unique_ptr<MeshUploader> meshUploader, uint32_t generationThreads)
+    : m_meshUploader(std::move(meshUploader)) {
     m_worldGenerator = std::make_unique<WorldGenerator>();
+    m_generationPool = std::make_unique<GenerationPool>(generationThreads);
+    m_generationPipeline = std::make_unique<GenerationPipeline>(*m_worldGenerator, *m_generationPool);
+    m_worldStorage = std::make_unique<WorldStorage>(m_chunkPool);
 }
 
 ChunkManager::~ChunkManager() {
     m_shouldStop = true;
-    if (m_generationThread.joinable()) {
-        m_generationThread.join();
-    }
+
+    // Persist edits before anything is torn down; the I/O thread finishes
+    // all queued writes before Close() returns
+    SaveModifiedChunks();
+    m_worldStorage->Close();
+    m_generationPool->Stop();
+
+    // No readers left - free everything that was retired
+    m_reclaimer.CollectAll();
+    MemoryAccounting::Set(MemoryCategory::Queues, 0);
 }
 
-void ChunkManager::Initialize() {
+void ChunkManager::Initialize(const std::string& worldDirectory) {
     Block::Initialize();
     m_worldGenerator->Initialize();
 
-    // Start generation thread
-    m_generationThread = std::thread(&ChunkManager::GenerationThreadFunc, this);
+    // Start generation workers
+    m_generationPool->Start();
+
+    // Without storage the world still works, it just isn't persisted
+    if (!m_worldStorage->Open(worldDirectory, [this](const glm::ivec3& position, std::unique_ptr<Chunk> chunk) {
+            OnChunkLoaded(position, std::move(chunk));
+        })) {
+        std::cerr << "World storage unavailable, edits will not be saved" << std::endl;
+    }
 
     // Load initial chunks around origin
     LoadChunksAroundPosition(glm::ivec3(0, 0, 0));
@@ -32,10 +52,29 @@ void ChunkManager::Initialize() {
     std::cout << "ChunkManager initialized" << std::endl;
 }
 
-void ChunkManager::Update(const glm::vec3& viewerPosition, float deltaTime) {
+bool ChunkManager::OpenBakedWorld(const std::string& path) {
+    return m_bakedWorld.Open(path);
+}
+
+void ChunkManager::Update(const glm::vec3& viewerPosition, const glm::vec3& viewDirection, float deltaTime) {
+    m_time += deltaTime;
     m_updateTimer += deltaTime;
+    m_prefetcher.Update(viewerPosition, viewDirection, deltaTime);
+
+    // Recycle unloaded chunks that no reader can reach anymore. Both steps are
+    // budgeted so a mass unload is spread over several frames.
+    m_reclaimer.Collect(MAX_RELEASES_PER_FRAME);
+    m_chunkPool.Trim(MAX_DESTROYS_PER_FRAME);
+
+    m_autosaveTimer += deltaTime;
+    if (m_autosaveTimer >= AUTOSAVE_INTERVAL) {
+        m_autosaveTimer = 0.0f;
+        SaveModifiedChunks();
+    }
+
+    // Columns whose bounds arrived queue their chunks right away
+    ProcessColumnBounds();
 
-    // Throttle chunk loading to avoid frame drops
     if (m_updateTimer < UPDATE_INTERVAL) {
         // Still process generated chunks every frame
         UpdateChunkMeshes();
@@ -46,91 +85,145 @@ void ChunkManager::Update(const glm::vec3& viewerPosition, float deltaTime) {
 
     glm::ivec3 newChunkPosition = WorldToChunkPosition(viewerPosition);
 
-    // Update chunks if position changed significantly
-    if (newChunkPosition != m_currentChunkPosition ||
+    glm::vec3 chunkSize(Chunk::SIZE, Chunk::HEIGHT, Chunk::SIZE);
+    glm::ivec3 predictedOffset = glm::ivec3(glm::round(m_prefetcher.GetPredictedOffset(chunkSize)));
+    bool predictionChanged = predictedOffset != m_predictedChunkOffset;
+    m_predictedChunkOffset = predictedOffset;
+
+    // Update chunks if position or prediction changed significantly
+    if (newChunkPosition != m_currentChunkPosition || predictionChanged ||
         glm::distance(viewerPosition, m_lastViewerPosition) > 8.0f) {
 
+        if (newChunkPosition != m_currentChunkPosition) {
+            RecordPrefetchArrivals(m_currentChunkPosition, newChunkPosition);
+
+            // Slide the chunk window; whatever falls out of it is unloaded
+            std::vector<std::unique_ptr<Chunk>> evicted;
+            m_chunkGrid.Recenter(newChunkPosition, evicted);
+            for (auto& chunk : evicted) {
+                OnChunkUnloaded(std::move(chunk));
+            }
+        }
+
+        bool chunkChanged = newChunkPosition != m_currentChunkPosition;
         m_currentChunkPosition = newChunkPosition;
         m_lastViewerPosition = viewerPosition;
 
+        // Render distance is measured from the viewer's chunk, so the visible
+        // set only changes when that chunk does
+        if (chunkChanged) {
+            m_chunkGrid.ForEach([this](Chunk* chunk) { UpdateChunkVisibility(chunk); });
+            PruneColumnBounds();
+            PruneDemotedChunks();
+        }
+
         LoadChunksAroundPosition(m_currentChunkPosition);
-        UnloadDistantChunks(m_currentChunkPosition);
+    } else if (m_skippedRequests && !IsBudgetFull()) {
+        LoadChunksAroundPosition(m_currentChunkPosition); // Back under the memory budget
     }
 
+    // Runs even when the viewer stands still so out-of-range timers expire
+    UnloadDistantChunks(m_currentChunkPosition);
+    EnforceMemoryBudget();
+
     // Process generated chunks
     UpdateChunkMeshes();
+    SampleQueueMemory();
 }
 
 void ChunkManager::UpdateChunkMeshes() {
-    // Process generated chunks from background thread
-    size_t newChunks = 0;
-    {
-        std::lock_guard<std::mutex> generatedLock(m_generatedMutex);
-        while (!m_generatedChunks.empty()) {
-            auto chunk = std::move(m_generatedChunks.front());
-            m_generatedChunks.pop();
-
-            glm::ivec3 position = chunk->GetPosition();
-
-            // Create OpenGL objects for new chunk (main thread only!)
-            chunk->CreateOpenGLObjects();
-
-            // Add to main chunk storage
-            {
-                std::lock_guard<std::mutex> chunksLock(m_chunksMutex);
-                m_chunks[position] = std::move(chunk);
-                UpdateChunkNeighbors(position);
-            }
-            newChunks++;
+    // Take a bounded number of generated chunks from the workers.
+    // The queue is lock-free, so a generation burst can't stall the frame.
+    int newChunks = 0;
+    std::unique_ptr<Chunk> chunk;
+    while (newChunks < MAX_CHUNKS_PER_FRAME && m_generatedChunks.TryPop(chunk)) {
+        glm::ivec3 position = chunk->GetPosition();
+        auto pending = m_pendingChunks.find(position);
+        if (pending != m_pendingChunks.end()) {
+            m_lifecycle.RecordRequest(*chunk, pending->second);
+            m_pendingChunks.erase(pending);
+        }
+
+        // Add to main chunk storage. Chunks requested before the viewer moved
+        // away may no longer fit in the window - those are simply dropped.
+        Chunk* inserted = chunk.get();
+        if (!m_chunkGrid.Insert(chunk)) {
+            m_lifecycle.BeginUnload(*chunk);
+            m_lifecycle.FinishUnload(*chunk);
+            m_chunkPool.Release(std::move(chunk)); // Never published, safe to reuse right away
+            continue;
         }
+        inserted->SetReclaimer(&m_reclaimer); // Readers can reach it now, writes go copy-on-write
+        m_lifecycle.Transition(*inserted, ChunkState::Generated, ChunkState::Meshing);
+        m_budgetUsage += inserted->GetMemoryUsage();
+
+        UpdateChunkNeighbors(inserted);
+        UpdateChunkVisibility(inserted);
+        newChunks++;
     }
 
     if (newChunks > 0) {
-        std::cout << "Loaded " << newChunks << " new chunks (OpenGL objects created in main thread)" << std::endl;
+        std::cout << "Loaded " << newChunks << " new chunks" << std::endl;
     }
 
-    // Update meshes for dirty chunks (OpenGL calls in main thread)
-    std::lock_guard<std::mutex> lock(m_chunksMutex);
-    for (auto& [pos, chunk] : m_chunks) {
-        if (chunk->NeedsMeshUpdate()) {
-            chunk->GenerateMesh(); // This will update buffers
+    // Update meshes for dirty chunks (uploads happen in main thread).
+    // Whatever doesn't fit in this frame's budget stays dirty for the next one.
+    int meshUpdates = 0;
+    m_chunkGrid.ForEach([this, &meshUpdates](Chunk* dirtyChunk) {
+        if (meshUpdates < MAX_MESH_UPDATES_PER_FRAME && dirtyChunk->NeedsMeshUpdate() &&
+            // Demoted meshes wait until needed, and so does everything beyond a shrunk render distance
+            ((!dirtyChunk->IsMeshReleased() && m_budgetShrink == 0) || IsInRenderDistance(dirtyChunk->GetPosition())) &&
+            // With the budget full only existing meshes are rebuilt (edits)
+            (!IsBudgetFull() || dirtyChunk->GetMeshMemoryUsage() > 0)) {
+            size_t meshBytes = dirtyChunk->GetMeshMemoryUsage();
+            dirtyChunk->GenerateMesh(*m_meshUploader); // This will update buffers
+            m_budgetUsage = m_budgetUsage - meshBytes + dirtyChunk->GetMeshMemoryUsage();
+            m_lifecycle.Transition(*dirtyChunk, ChunkState::Meshing, ChunkState::Uploaded); // First mesh only
+            UpdateChunkVisibility(dirtyChunk); // Emptiness is only known after meshing
+            meshUpdates++;
         }
-    }
+    });
 }
 
-Chunk* ChunkManager::GetChunk(const glm::ivec3& position) {
-    std::lock_guard<std::mutex> lock(m_chunksMutex);
-    auto it = m_chunks.find(position);
-    return (it != m_chunks.end()) ? it->second.get() : nullptr;
+bool ChunkManager::IsInRenderDistance(const glm::ivec3& chunkPosition) const {
+    // Chunk center measured from the viewer chunk's corner, in chunks
+    glm::vec3 offset = glm::vec3(chunkPosition - m_currentChunkPosition) + glm::vec3(0.5f);
+    return glm::length(offset) <= GetRenderDistance();
 }
 
-std::vector<Chunk*> ChunkManager::GetVisibleChunks() const {
-    std::vector<Chunk*> visibleChunks;
-
-    std::lock_guard<std::mutex> lock(m_chunksMutex);
-    visibleChunks.reserve(m_chunks.size());
-
-    for (const auto& [pos, chunk] : m_chunks) {
-        // Check distance from current viewer position
-        glm::vec3 chunkCenter = glm::vec3(pos) * glm::vec3(Chunk::SIZE, Chunk::HEIGHT, Chunk::SIZE) +
-                               glm::vec3(Chunk::SIZE, Chunk::HEIGHT, Chunk::SIZE) * 0.5f;
-        glm::vec3 viewerChunkCenter = glm::vec3(m_currentChunkPosition) *
-                                     glm::vec3(Chunk::SIZE, Chunk::HEIGHT, Chunk::SIZE);
-
-        float distance = glm::length(chunkCenter - viewerChunkCenter) / Chunk::SIZE;
+void ChunkManager::UpdateChunkVisibility(Chunk* chunk) {
+    bool shouldBeVisible = !chunk->IsEmpty() && IsInRenderDistance(chunk->GetPosition());
+    bool isVisible = chunk->GetVisibleIndex() >= 0;
+
+    if (shouldBeVisible && !isVisible) {
+        chunk->SetVisibleIndex(static_cast<int>(m_visibleChunks.size()));
+        m_visibleChunks.push_back(chunk);
+        m_lifecycle.Transition(*chunk, ChunkState::Uploaded, ChunkState::Visible);
+    } else if (!shouldBeVisible && isVisible) {
+        RemoveFromVisible(chunk);
+        m_lifecycle.Transition(*chunk, ChunkState::Visible, ChunkState::Uploaded);
+    }
+}
 
-        if (distance <= RENDER_DISTANCE && !chunk->IsEmpty()) {
-            visibleChunks.push_back(chunk.get());
-        }
+void ChunkManager::RemoveFromVisible(Chunk* chunk) {
+    int index = chunk->GetVisibleIndex();
+    if (index < 0) {
+        return;
     }
 
-    return visibleChunks;
+    // Swap with the last entry so removal stays O(1)
+    Chunk* last = m_visibleChunks.back();
+    m_visibleChunks[index] = last;
+    last->SetVisibleIndex(index);
+    m_visibleChunks.pop_back();
+    chunk->SetVisibleIndex(-1);
 }
 
-BlockType ChunkManager::GetBlock(int x, int y, int z) {
+BlockType ChunkManager::GetBlock(int x, int y, int z) const {
     glm::ivec3 chunkPos = GetChunkPositionFromBlock(x, y, z);
     glm::ivec3 blockPos = WorldToBlockPosition(x, y, z);
 
+    EpochReclaimer::Guard guard = m_reclaimer.Pin();
     Chunk* chunk = GetChunk(chunkPos);
     if (chunk) {
         return chunk->GetBlock(blockPos.x, blockPos.y, blockPos.z);
@@ -139,13 +232,73 @@ BlockType ChunkManager::GetBlock(int x, int y, int z) {
     return BlockType::Air;
 }
 
+size_t ChunkManager::GetRegionVolume(const glm::ivec3& min, const glm::ivec3& max) {
+    glm::ivec3 size = max - min + glm::ivec3(1);
+    if (size.x <= 0 || size.y <= 0 || size.z <= 0) {
+        return 0;
+    }
+    return static_cast<size_t>(size.x) * size.y * size.z;
+}
+
+void ChunkManager::CopyRegion(const glm::ivec3& min, const glm::ivec3& max, BlockType* out) const {
+    if (GetRegionVolume(min, max) == 0) {
+        return;
+    }
+
+    const glm::ivec3 size = max - min + glm::ivec3(1);
+    const size_t rowStride = size.x;
+    const size_t layerStride = static_cast<size_t>(size.x) * size.z;
+
+    const glm::ivec3 chunkMin = GetChunkPositionFromBlock(min.x, min.y, min.z);
+    const glm::ivec3 chunkMax = GetChunkPositionFromBlock(max.x, max.y, max.z);
+    const glm::ivec3 chunkSize(Chunk::SIZE, Chunk::HEIGHT, Chunk::SIZE);
+
+    EpochReclaimer::Guard guard = m_reclaimer.Pin();
+
+    for (int cy = chunkMin.y; cy <= chunkMax.y; ++cy) {
+        for (int cz = chunkMin.z; cz <= chunkMax.z; ++cz) {
+            for (int cx = chunkMin.x; cx <= chunkMax.x; ++cx) {
+                const glm::ivec3 chunkPos(cx, cy, cz);
+                const glm::ivec3 origin = chunkPos * chunkSize;
+                const glm::ivec3 from = glm::max(min, origin);
+                const glm::ivec3 to = glm::min(max, origin + chunkSize - glm::ivec3(1));
+
+                const glm::ivec3 offset = from - min;
+                BlockType* dst = out + offset.y * layerStride + offset.z * rowStride + offset.x;
+
+                if (const Chunk* chunk = m_chunkGrid.Get(chunkPos)) {
+                    chunk->CopyBlocks(from - origin, to - origin, dst, rowStride, layerStride);
+                } else {
+                    // Not loaded - fill with Air
+                    for (int y = from.y; y <= to.y; ++y) {
+                        for (int z = from.z; z <= to.z; ++z) {
+                            std::fill_n(dst + (y - from.y) * layerStride + (z - from.z) * rowStride,
+                                        to.x - from.x + 1, BlockType::Air);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
 void ChunkManager::SetBlock(int x, int y, int z, BlockType type) {
     glm::ivec3 chunkPos = GetChunkPositionFromBlock(x, y, z);
     glm::ivec3 blockPos = WorldToBlockPosition(x, y, z);
 
     Chunk* chunk = GetChunk(chunkPos);
-    if (chunk) {
+    if (!chunk && type != BlockType::Air) {
+        chunk = CreateEmptyChunk(chunkPos); // Building into the sky
+    }
+
+    if (chunk && chunk->GetBlock(blockPos.x, blockPos.y, blockPos.z) != type) {
         chunk->SetBlock(blockPos.x, blockPos.y, blockPos.z, type);
+
+        if (m_saveMode == SaveMode::EditJournal) {
+            m_worldStorage->RecordEdit(chunkPos, blockPos.x, blockPos.y, blockPos.z, type);
+        } else {
+            chunk->SetModified(true);
+        }
     }
 }
 
@@ -157,76 +310,301 @@ glm::ivec3 ChunkManager::WorldToChunkPosition(const glm::vec3& worldPos) const {
     );
 }
 
-glm::ivec3 ChunkManager::WorldToBlockPosition(int x, int y, int z) const {
-    return glm::ivec3(
-        ((x % Chunk::SIZE) + Chunk::SIZE) % Chunk::SIZE,
-        ((y % Chunk::HEIGHT) + Chunk::HEIGHT) % Chunk::HEIGHT,
-        ((z % Chunk::SIZE) + Chunk::SIZE) % Chunk::SIZE
-    );
+void ChunkManager::LoadChunksAroundPosition(const glm::ivec3& centerChunk) {
+    // Use priority queue to load the most urgent chunks first
+    std::priority_queue<ChunkLoadRequest> loadQueue;
+    m_skippedRequests = false;
+    m_skippedEmptyChunks = 0;
+    m_deferredBuriedChunks = 0;
+
+    // The load region is the circle of columns around the viewer plus the
+    // same circle around the predicted position, clipped to the chunk window
+    const glm::ivec3 predicted = m_predictedChunkOffset;
+    const int loadDistance = GetLoadDistance();
+    const int fromX = std::min(0, predicted.x) - loadDistance;
+    const int toX = std::max(0, predicted.x) + loadDistance;
+    const int fromZ = std::min(0, predicted.z) - loadDistance;
+    const int toZ = std::max(0, predicted.z) + loadDistance;
+
+    // Columns still missing their bounds, with the priority of their nearest chunk
+    std::vector<std::pair<float, glm::ivec2>> missingColumns;
+
+    for (int x = fromX; x <= toX; ++x) {
+        for (int z = fromZ; z <= toZ; ++z) {
+            glm::ivec2 column(centerChunk.x + x, centerChunk.z + z);
+            if (IsColumnInLoadRange(column, centerChunk) && !QueueColumnChunks(column, centerChunk, loadQueue)) {
+                missingColumns.emplace_back(m_prefetcher.GetPriority(glm::vec3(x, 0.0f, z)), column);
+            }
+        }
+    }
+
+    // The pool runs tasks in submission order, so submitting the bounds
+    // nearest-ahead first makes their chunks arrive (and load) in that order
+    std::sort(missingColumns.begin(), missingColumns.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (const auto& [priority, column] : missingColumns) {
+        RequestColumnBounds(column);
+    }
+
+    // Process load requests
+    while (!loadQueue.empty()) {
+        ChunkLoadRequest request = loadQueue.top();
+        loadQueue.pop();
+        RequestChunkGeneration(request.position);
+    }
 }
 
-glm::ivec3 ChunkManager::GetChunkPositionFromBlock(int x, int y, int z) const {
-    return glm::ivec3(
-        std::floor((float)x / Chunk::SIZE),
-        std::floor((float)y / Chunk::HEIGHT),
-        std::floor((float)z / Chunk::SIZE)
-    );
+bool ChunkManager::IsColumnInLoadRange(const glm::ivec2& column, const glm::ivec3& centerChunk) const {
+    glm::ivec2 offset = column - glm::ivec2(centerChunk.x, centerChunk.z);
+    if (glm::length(glm::vec2(offset)) <= GetLoadDistance()) {
+        return true;
+    }
+
+    glm::ivec2 predicted(m_predictedChunkOffset.x, m_predictedChunkOffset.z);
+    return predicted != glm::ivec2(0) && glm::length(glm::vec2(offset - predicted)) <= GetLoadDistance();
 }
 
-void ChunkManager::LoadChunksAroundPosition(const glm::ivec3& centerChunk) {
-    // Use priority queue to load closest chunks first
-    std::priority_queue<ChunkLoadRequest> loadQueue;
+bool ChunkManager::QueueColumnChunks(const glm::ivec2& column, const glm::ivec3& centerChunk,
+                                     std::priority_queue<ChunkLoadRequest>& loadQueue) {
+    // Band around the viewer (and where it is heading)
+    int minY = centerChunk.y + std::min(0, m_predictedChunkOffset.y) - VERTICAL_LOAD_DISTANCE;
+    int maxY = centerChunk.y + std::max(0, m_predictedChunkOffset.y) + VERTICAL_LOAD_DISTANCE;
+
+    const WorldGenerator::ColumnBounds* bounds = nullptr;
+    if (UsesColumnCulling()) {
+        auto it = m_columnBounds.find(column);
+        if (it == m_columnBounds.end()) {
+            return false; // Chunks are queued once the bounds arrive
+        }
+        bounds = &it->second;
 
-    // Generate load requests
-    for (int x = -LOAD_DISTANCE; x <= LOAD_DISTANCE; ++x) {
-        for (int z = -LOAD_DISTANCE; z <= LOAD_DISTANCE; ++z) {
-            for (int y = -2; y <= 2; ++y) { // Limit vertical range
-                glm::ivec3 chunkPos = centerChunk + glm::ivec3(x, y, z);
+        // Widen the band to the column's surface, so mountains and valleys
+        // outside it still load
+        minY = std::min(minY, Math::FloorDiv(bounds->minSurface, Chunk::HEIGHT));
+        maxY = std::max(maxY, Math::FloorDiv(bounds->maxContent, Chunk::HEIGHT));
+    }
+    minY = std::max(minY, centerChunk.y - MAX_VERTICAL_DISTANCE);
+    maxY = std::min(maxY, centerChunk.y + MAX_VERTICAL_DISTANCE);
 
-                float distance = glm::length(glm::vec3(x, y * 2, z)); // Weight Y more
+    const glm::ivec2 horizontal = column - glm::ivec2(centerChunk.x, centerChunk.z);
+    const bool prefetched = glm::length(glm::vec2(horizontal)) > GetLoadDistance();
 
-                if (distance <= LOAD_DISTANCE) {
-                    // Check if chunk already exists
-                    bool exists = false;
-                    {
-                        std::lock_guard<std::mutex> lock(m_chunksMutex);
-                        exists = m_chunks.find(chunkPos) != m_chunks.end();
-                    }
+    for (int y = minY; y <= maxY; ++y) {
+        glm::ivec3 chunkPos(column.x, y, column.y);
+        if (!m_chunkGrid.IsInside(chunkPos) || m_chunkGrid.Get(chunkPos)) {
+            continue;
+        }
 
-                    if (!exists) {
-                        loadQueue.push({chunkPos, distance});
-                    }
-                }
+        // Demoted under memory pressure - stays out until the viewer comes close
+        if (m_demotedChunks.count(chunkPos)) {
+            if (!IsInPromoteDistance(chunkPos)) {
+                continue;
+            }
+            m_demotedChunks.erase(chunkPos);
+        }
+
+        glm::ivec3 offset = chunkPos - centerChunk;
+        if (bounds && !HasStoredData(chunkPos)) {
+            WorldGenerator::ChunkContent content = m_worldGenerator->ClassifyChunk(*bounds, y);
+            if (content == WorldGenerator::ChunkContent::Empty) {
+                m_skippedEmptyChunks++;
+                continue;
+            }
+
+            glm::ivec3 distance = glm::abs(offset);
+            if (content == WorldGenerator::ChunkContent::Buried &&
+                std::max({distance.x, distance.y, distance.z}) > BURIED_LOAD_DISTANCE) {
+                m_deferredBuriedChunks++;
+                continue;
             }
         }
+
+        if (prefetched && !m_pendingChunks.count(chunkPos)) {
+            m_prefetcher.CountPrefetchRequest();
+        }
+        loadQueue.push({chunkPos, m_prefetcher.GetPriority(glm::vec3(offset))});
+    }
+    return true;
+}
+
+void ChunkManager::RequestColumnBounds(const glm::ivec2& column) {
+    if (!m_pendingColumns.insert(column).second) {
+        return;
+    }
+
+    m_generationPool->Submit([this, column] {
+        if (m_shouldStop) {
+            return;
+        }
+
+        ColumnBoundsResult result;
+        result.column = column;
+        result.bounds = m_worldGenerator->GetColumnBounds(column.x, column.y);
+        while (!m_columnResults.TryPush(std::move(result))) {
+            if (m_shouldStop) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+    });
+}
+
+void ChunkManager::ProcessColumnBounds() {
+    std::priority_queue<ChunkLoadRequest> loadQueue;
+
+    int processed = 0;
+    ColumnBoundsResult result;
+    while (processed < MAX_COLUMNS_PER_FRAME && m_columnResults.TryPop(result)) {
+        m_pendingColumns.erase(result.column);
+        m_columnBounds[result.column] = result.bounds;
+        processed++;
+
+        // The viewer may have moved on while the bounds were computed
+        if (IsColumnInLoadRange(result.column, m_currentChunkPosition)) {
+            QueueColumnChunks(result.column, m_currentChunkPosition, loadQueue);
+        }
     }
 
-    // Process load requests
     while (!loadQueue.empty()) {
-        ChunkLoadRequest request = loadQueue.top();
+        RequestChunkGeneration(loadQueue.top().position);
         loadQueue.pop();
-        RequestChunkGeneration(request.position);
     }
 }
 
-void ChunkManager::UnloadDistantChunks(const glm::ivec3& centerChunk) {
-    std::vector<glm::ivec3> chunksToUnload;
+void ChunkManager::PruneColumnBounds() {
+    // Only columns of the chunk window are worth keeping
+    for (auto it = m_columnBounds.begin(); it != m_columnBounds.end();) {
+        if (!m_chunkGrid.IsInside(glm::ivec3(it->first.x, m_currentChunkPosition.y, it->first.y))) {
+            it = m_columnBounds.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
 
-    {
-        std::lock_guard<std::mutex> lock(m_chunksMutex);
+bool ChunkManager::IsCulledByColumn(const glm::ivec3& position, const glm::ivec3& center) const {
+    if (!UsesColumnCulling() || HasStoredData(position)) {
+        return false;
+    }
+
+    auto it = m_columnBounds.find(glm::ivec2(position.x, position.z));
+    if (it == m_columnBounds.end()) {
+        return false;
+    }
+
+    // Same decisions QueueColumnChunks makes
+    WorldGenerator::ChunkContent content = m_worldGenerator->ClassifyChunk(it->second, position.y);
+    if (content == WorldGenerator::ChunkContent::Empty) {
+        return true;
+    }
+
+    glm::ivec3 distance = glm::abs(position - center);
+    return content == WorldGenerator::ChunkContent::Buried &&
+           std::max({distance.x, distance.y, distance.z}) > BURIED_LOAD_DISTANCE;
+}
 
-        for (const auto& [pos, chunk] : m_chunks) {
-            glm::vec3 diff = glm::vec3(pos - centerChunk);
-            float distance = glm::length(diff);
+bool ChunkManager::HasStoredData(const glm::ivec3& position) const {
+    // Edited chunks never count as empty or buried, whatever the generator says
+    return m_worldStorage->IsOpen() &&
+           (m_worldStorage->HasEdits(position) || m_worldStorage->MayContain(position));
+}
 
-            if (distance > UNLOAD_DISTANCE) {
-                chunksToUnload.push_back(pos);
+Chunk* ChunkManager::CreateEmptyChunk(const glm::ivec3& position) {
+    if (!UsesColumnCulling() || !m_chunkGrid.IsInside(position) || m_pendingChunks.count(position)) {
+        return nullptr;
+    }
+
+    // Only chunks the column bounds prove empty - anything else has to be generated
+    auto it = m_columnBounds.find(glm::ivec2(position.x, position.z));
+    if (it == m_columnBounds.end() ||
+        m_worldGenerator->ClassifyChunk(it->second, position.y) != WorldGenerator::ChunkContent::Empty ||
+        HasStoredData(position)) {
+        return nullptr;
+    }
+
+    auto chunk = m_chunkPool.Acquire(position); // Acquired chunks are all Air
+    m_lifecycle.Transition(*chunk, ChunkState::Generating, ChunkState::Generated);
+
+    Chunk* inserted = chunk.get();
+    if (!m_chunkGrid.Insert(chunk)) {
+        m_chunkPool.Release(std::move(chunk));
+        return nullptr;
+    }
+
+    inserted->SetReclaimer(&m_reclaimer);
+    m_lifecycle.Transition(*inserted, ChunkState::Generated, ChunkState::Meshing);
+    UpdateChunkNeighbors(inserted);
+    UpdateChunkVisibility(inserted);
+    return inserted;
+}
+
+bool ChunkManager::IsInUnloadRange(const glm::ivec3& chunkPosition, const glm::ivec3& centerChunk) const {
+    glm::ivec3 diff = chunkPosition - centerChunk;
+    if (glm::length(glm::vec2(diff.x, diff.z)) <= UNLOAD_DISTANCE && std::abs(diff.y) <= VERTICAL_UNLOAD_DISTANCE) {
+        return true;
+    }
+
+    // Keep what was prefetched ahead of the viewer
+    glm::ivec3 ahead = diff - m_predictedChunkOffset;
+    return m_predictedChunkOffset != glm::ivec3(0) &&
+           glm::length(glm::vec2(ahead.x, ahead.z)) <= LOAD_DISTANCE && std::abs(ahead.y) <= MAX_VERTICAL_DISTANCE;
+}
+
+void ChunkManager::RecordPrefetchArrivals(const glm::ivec3& oldCenter, const glm::ivec3& newCenter) {
+    // Chunks that just came within NEAR_DISTANCE: loaded ones are hits,
+    // missing ones would pop in right in front of the viewer
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+
+    for (int x = -NEAR_DISTANCE; x <= NEAR_DISTANCE; ++x) {
+        for (int z = -NEAR_DISTANCE; z <= NEAR_DISTANCE; ++z) {
+            for (int y = -1; y <= 1; ++y) {
+                glm::ivec3 position = newCenter + glm::ivec3(x, y, z);
+                glm::ivec3 previous = position - oldCenter;
+                if (std::abs(previous.x) <= NEAR_DISTANCE && std::abs(previous.z) <= NEAR_DISTANCE &&
+                    std::abs(previous.y) <= 1) {
+                    continue; // Was already near
+                }
+
+                // Never loaded on purpose - says nothing about the prefetcher
+                if (IsCulledByColumn(position, newCenter)) {
+                    continue;
+                }
+
+                if (m_chunkGrid.Get(position)) {
+                    hits++;
+                } else {
+                    misses++;
+                }
             }
         }
+    }
+
+    m_prefetcher.RecordArrivals(hits, misses);
+}
 
-        // Remove chunks
-        for (const auto& pos : chunksToUnload) {
-            m_chunks.erase(pos);
+void ChunkManager::UnloadDistantChunks(const glm::ivec3& centerChunk) {
+    std::vector<glm::ivec3> chunksToUnload;
+
+    m_chunkGrid.ForEach([&](Chunk* chunk) {
+        if (IsInUnloadRange(chunk->GetPosition(), centerChunk)) {
+            chunk->SetOutOfRangeTime(-1.0f); // Came back in range
+            return;
+        }
+
+        if (chunk->GetOutOfRangeTime() < 0.0f) {
+            chunk->SetOutOfRangeTime(m_time);
+        } else if (m_time - chunk->GetOutOfRangeTime() >= UNLOAD_DELAY &&
+                   chunksToUnload.size() < MAX_UNLOADS_PER_FRAME) {
+            chunksToUnload.push_back(chunk->GetPosition());
+        }
+    });
+
+    // Remove chunks
+    for (const auto& pos : chunksToUnload) {
+        std::unique_ptr<Chunk> chunk = m_chunkGrid.Remove(pos);
+        if (chunk) {
+            OnChunkUnloaded(std::move(chunk));
         }
     }
 
@@ -236,110 +614,420 @@ void ChunkManager::UnloadDistantChunks(const glm::ivec3& centerChunk) {
 }
 
 void ChunkManager::RequestChunkGeneration(const glm::ivec3& position) {
-    // Check if already in queue
-    {
-        std::lock_guard<std::mutex> lock(m_queueMutex);
-
-        // Simple check - in production you'd want a set to track queued positions
-        std::queue<glm::ivec3> tempQueue = m_generationQueue;
-        while (!tempQueue.empty()) {
-            if (tempQueue.front() == position) {
-                return; // Already queued
-            }
-            tempQueue.pop();
+    // Every new chunk adds memory; Update() asks again once there is room
+    if (IsBudgetFull()) {
+        m_skippedRequests = true;
+        return;
+    }
+
+    // Skip positions that are already queued or being generated
+    if (!m_pendingChunks.emplace(position, std::chrono::steady_clock::now()).second) {
+        return;
+    }
+
+    // Compressed under memory pressure - decoding beats regenerating
+    std::vector<uint8_t> compressed;
+    if (m_compressedChunks.Take(position, compressed)) {
+        auto data = std::make_shared<std::vector<uint8_t>>(std::move(compressed));
+        m_generationPool->Submit([this, position, data] { DecodeChunkTask(position, *data); });
+        return;
+    }
+
+    // Stored chunks are read back instead of regenerated
+    if (m_worldStorage->IsOpen() && m_worldStorage->MayContain(position)) {
+        m_worldStorage->RequestLoad(position);
+        return;
+    }
+
+    m_generationPool->Submit([this, position] { GenerateChunkTask(position); });
+}
+
+void ChunkManager::OnChunkLoaded(const glm::ivec3& position, std::unique_ptr<Chunk> chunk) {
+    if (m_shouldStop) {
+        if (chunk) {
+            m_chunkPool.Release(std::move(chunk));
         }
+        return;
+    }
 
-        m_generationQueue.push(position);
+    if (!chunk) {
+        // Not stored after all - generate it
+        m_generationPool->Submit([this, position] { GenerateChunkTask(position); });
+        return;
     }
+
+    PublishChunk(std::move(chunk));
 }
 
-void ChunkManager::UpdateChunkNeighbors(const glm::ivec3& position) {
-    Chunk* chunk = GetChunk(position);
-    if (!chunk) return;
+void ChunkManager::SaveChunk(Chunk* chunk) {
+    ChunkSnapshot snapshot;
+    snapshot.Capture(*chunk);
+    m_worldStorage->Save(std::move(snapshot));
+    chunk->SetModified(false);
+}
 
-    // Set neighbors
-    chunk->SetNeighbor(0, GetChunk(position + glm::ivec3(-1, 0, 0))); // -X
-    chunk->SetNeighbor(1, GetChunk(position + glm::ivec3(1, 0, 0)));  // +X
-    chunk->SetNeighbor(2, GetChunk(position + glm::ivec3(0, -1, 0))); // -Y
-    chunk->SetNeighbor(3, GetChunk(position + glm::ivec3(0, 1, 0)));  // +Y
-    chunk->SetNeighbor(4, GetChunk(position + glm::ivec3(0, 0, -1))); // -Z
-    chunk->SetNeighbor(5, GetChunk(position + glm::ivec3(0, 0, 1)));  // +Z
+void ChunkManager::SaveModifiedChunks() {
+    if (!m_worldStorage->IsOpen()) {
+        return;
+    }
+
+    size_t saved = 0;
+    m_chunkGrid.ForEach([this, &saved](Chunk* chunk) {
+        if (chunk->IsModified()) {
+            SaveChunk(chunk);
+            saved++;
+        }
+    });
+
+    if (saved > 0) {
+        std::cout << "Queued " << saved << " modified chunks for saving" << std::endl;
+    }
+}
+
+void ChunkManager::SaveWorld() {
+    SaveModifiedChunks();
+    m_worldStorage->Flush();
+}
+
+// Neighbor directions: -X, +X, -Y, +Y, -Z, +Z
+static const glm::ivec3 NEIGHBOR_OFFSETS[6] = {
+    glm::ivec3(-1, 0, 0), glm::ivec3(1, 0, 0),
+    glm::ivec3(0, -1, 0), glm::ivec3(0, 1, 0),
+    glm::ivec3(0, 0, -1), glm::ivec3(0, 0, 1)
+};
+
+void ChunkManager::UpdateChunkNeighbors(Chunk* chunk) {
+    const glm::ivec3& position = chunk->GetPosition();
 
-    // Update neighbors to point back to this chunk
     for (int i = 0; i < 6; ++i) {
-        glm::ivec3 offset(0);
-        int oppositeDir = 0;
+        Chunk* neighbor = m_chunkGrid.Get(position + NEIGHBOR_OFFSETS[i]);
+        chunk->SetNeighbor(i, neighbor);
 
-        switch (i) {
-            case 0: offset.x = -1; oppositeDir = 1; break;
-            case 1: offset.x = 1; oppositeDir = 0; break;
-            case 2: offset.y = -1; oppositeDir = 3; break;
-            case 3: offset.y = 1; oppositeDir = 2; break;
-            case 4: offset.z = -1; oppositeDir = 5; break;
-            case 5: offset.z = 1; oppositeDir = 4; break;
+        // Update neighbor to point back to this chunk (opposite direction is i ^ 1)
+        if (neighbor) {
+            neighbor->SetNeighbor(i ^ 1, chunk);
+            neighbor->MarkDirty(); // Neighbor might need mesh update
         }
+    }
+}
 
-        Chunk* neighbor = GetChunk(position + offset);
+void ChunkManager::UnlinkChunkNeighbors(Chunk* chunk) {
+    for (int i = 0; i < 6; ++i) {
+        Chunk* neighbor = chunk->GetNeighbor(i);
         if (neighbor) {
-            neighbor->SetNeighbor(oppositeDir, chunk);
-            neighbor->MarkDirty(); // Neighbor might need mesh update
+            neighbor->SetNeighbor(i ^ 1, nullptr);
+            neighbor->MarkDirty(); // Exposed boundary faces need to be rebuilt
+            chunk->SetNeighbor(i, nullptr);
         }
     }
 }
 
-void ChunkManager::GenerationThreadFunc() {
-    std::cout << "Chunk generation thread started" << std::endl;
+void ChunkManager::OnChunkUnloaded(std::unique_ptr<Chunk> chunk) {
+    // Only a copy of the block data is queued, the I/O thread does the rest
+    if (chunk->IsModified() && m_worldStorage->IsOpen()) {
+        SaveChunk(chunk.get());
+    }
 
-    while (!m_shouldStop) {
-        glm::ivec3 chunkPos;
-        bool hasWork = false;
+    RemoveFromVisible(chunk.get());
+    UnlinkChunkNeighbors(chunk.get());
+    m_lifecycle.BeginUnload(*chunk);
 
-        // Get next chunk to generate
-        {
-            std::lock_guard<std::mutex> lock(m_queueMutex);
-            if (!m_generationQueue.empty()) {
-                chunkPos = m_generationQueue.front();
-                m_generationQueue.pop();
-                hasWork = true;
-            }
-        }
+    // Other threads may still hold the pointer; free it once they've moved on
+    Chunk* retired = chunk.release();
+    m_reclaimer.Retire([this, retired] {
+        m_lifecycle.FinishUnload(*retired);
+        m_chunkPool.Release(std::unique_ptr<Chunk>(retired));
+    });
+}
 
-        if (hasWork) {
-            // Generate chunk
-            auto chunk = std::make_unique<Chunk>(chunkPos);
-            m_worldGenerator->GenerateChunk(chunk.get());
+void ChunkManager::GenerateChunkTask(const glm::ivec3& position) {
+    if (m_shouldStop) {
+        return;
+    }
 
-            // Add to generated chunks queue
-            {
-                std::lock_guard<std::mutex> lock(m_generatedMutex);
-                m_generatedChunks.push(std::move(chunk));
-            }
-        } else {
-            // No work, sleep briefly
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    auto chunk = m_chunkPool.Acquire(position);
+    if (m_bakedWorld.IsOpen()) {
+        m_bakedWorld.LoadChunk(*chunk); // Zero-copy, no generation
+        m_worldStorage->ApplyEdits(*chunk);
+        PublishChunk(std::move(chunk));
+        return;
+    }
+
+    // Stages run as their columns become available, possibly on other workers
+    m_generationPipeline->Submit(std::move(chunk), [this](std::unique_ptr<Chunk> generated) {
+        if (m_shouldStop) {
+            m_chunkPool.Release(std::move(generated));
+            return;
         }
+        m_worldStorage->ApplyEdits(*generated); // Player edits on top of the generated terrain
+        PublishChunk(std::move(generated));
+    });
+}
+
+void ChunkManager::DecodeChunkTask(const glm::ivec3& position, const std::vector<uint8_t>& data) {
+    if (m_shouldStop) {
+        return;
     }
 
-    std::cout << "Chunk generation thread stopped" << std::endl;
+    ChunkSnapshot snapshot;
+    auto chunk = m_chunkPool.Acquire(position);
+    if (!ChunkCodec::Decode(data.data(), data.size(), snapshot) ||
+        !chunk->LoadBlockData(snapshot.palette, snapshot.indices)) {
+        m_chunkPool.Release(std::move(chunk));
+        GenerateChunkTask(position);
+        return;
+    }
+
+    PublishChunk(std::move(chunk));
+}
+
+void ChunkManager::PublishChunk(std::unique_ptr<Chunk> chunk) {
+    m_lifecycle.Transition(*chunk, ChunkState::Generating, ChunkState::Generated);
+
+    // Hand the chunk to the main thread. When the queue is full the main thread
+    // is behind its budget - back off instead of piling up more work.
+    while (!m_generatedChunks.TryPush(std::move(chunk))) {
+        if (m_shouldStop) {
+            m_chunkPool.Release(std::move(chunk)); // Don't destroy GPU objects off the main thread
+            return;
+        }
+        std::this_thread::yield();
+    }
 }
 
 size_t ChunkManager::GetLoadedChunkCount() const {
-    std::lock_guard<std::mutex> lock(m_chunksMutex);
-    return m_chunks.size();
+    return m_chunkGrid.GetCount();
 }
 
 size_t ChunkManager::GetTotalMemoryUsage() const {
     size_t total = 0;
-    std::lock_guard<std::mutex> lock(m_chunksMutex);
-
-    for (const auto& [pos, chunk] : m_chunks) {
+    m_chunkGrid.ForEach([&total](const Chunk* chunk) {
         total += chunk->GetMemoryUsage();
-    }
+    });
 
     return total;
 }
 
+ChunkManager::MemoryUsage ChunkManager::GetMemoryUsage() const {
+    MemoryUsage usage;
+    m_chunkGrid.ForEach([&usage](const Chunk* chunk) {
+        usage.voxelBytes += chunk->GetMemoryUsage();
+        usage.meshBytes += chunk->GetMeshMemoryUsage();
+    });
+    usage.compressedBytes = m_compressedChunks.GetMemoryUsage();
+    usage.pooledBytes = m_chunkPool.GetMemoryUsage();
+    return usage;
+}
+
+ChunkManager::ChunkResidency ChunkManager::GetResidency(const glm::ivec3& position) const {
+    if (const Chunk* chunk = m_chunkGrid.Get(position)) {
+        return chunk->IsMeshReleased() ? ChunkResidency::VoxelOnly : ChunkResidency::Meshed;
+    }
+    return m_compressedChunks.Contains(position) ? ChunkResidency::Compressed : ChunkResidency::Evicted;
+}
+
+bool ChunkManager::IsInPromoteDistance(const glm::ivec3& chunkPosition) const {
+    glm::vec3 offset = glm::vec3(chunkPosition - m_currentChunkPosition) + glm::vec3(0.5f);
+    return glm::length(offset) <= PROMOTE_DISTANCE - m_budgetShrink;
+}
+
+void ChunkManager::EnforceMemoryBudget() {
+    if (m_memoryBudget.maxBytes == 0) {
+        return;
+    }
+
+    MemoryUsage usage = GetMemoryUsage();
+    m_budgetUsage = usage.GetTotal();
+    if (m_budgetUsage <= m_memoryBudget.maxBytes) {
+        // Plenty of room for a while - give the distances back one step at a time
+        if (m_budgetShrink > 0 && m_time >= m_budgetGrowTime &&
+            m_budgetUsage < m_memoryBudget.maxBytes * BUDGET_GROW_WATERMARK) {
+            SetBudgetShrink(m_budgetShrink - 1);
+        }
+        return;
+    }
+
+    m_budgetGrowTime = m_time + BUDGET_GROW_DELAY;
+
+    const size_t target = static_cast<size_t>(m_memoryBudget.maxBytes * m_memoryBudget.lowWatermark);
+    int demotions = MAX_DEMOTIONS_PER_FRAME;
+
+    // Pooled chunks are memory nobody uses - they go first
+    m_chunkPool.Shrink(0, MAX_DESTROYS_PER_FRAME);
+    size_t total = usage.GetTotal() - usage.pooledBytes + m_chunkPool.GetMemoryUsage();
+
+    // Farthest and least recently seen first. A chunk entered Uploaded when
+    // it was first meshed or last left the visible set.
+    struct Candidate {
+        Chunk* chunk;
+        float score;
+    };
+    std::vector<Candidate> candidates;
+    const Chunk::TimePoint now = std::chrono::steady_clock::now();
+    m_chunkGrid.ForEach([&](Chunk* chunk) {
+        if (IsInPromoteDistance(chunk->GetPosition())) {
+            return;
+        }
+
+        Chunk::TimePoint lastSeen = std::max(chunk->GetStateTime(ChunkState::Generated),
+                                             chunk->GetStateTime(ChunkState::Uploaded));
+        float idle = std::chrono::duration<float>(now - lastSeen).count();
+        float distance = glm::length(glm::vec3(chunk->GetPosition() - m_currentChunkPosition));
+        candidates.push_back({chunk, distance + idle / LRU_SECONDS_PER_CHUNK});
+    });
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+
+    // Meshed -> VoxelOnly: drop GPU meshes
+    for (const Candidate& candidate : candidates) {
+        if (total <= target || demotions == 0) {
+            break;
+        }
+
+        size_t meshBytes = candidate.chunk->GetMeshMemoryUsage();
+        if (meshBytes > 0) {
+            candidate.chunk->ReleaseMesh();
+            total -= meshBytes;
+            demotions--;
+        }
+    }
+
+    // VoxelOnly -> Compressed: encode and take the chunk out of the grid
+    for (const Candidate& candidate : candidates) {
+        if (total <= target || demotions == 0) {
+            break;
+        }
+
+        const glm::ivec3 position = candidate.chunk->GetPosition();
+        size_t chunkBytes = candidate.chunk->GetMemoryUsage() + candidate.chunk->GetMeshMemoryUsage();
+        size_t cacheBefore = m_compressedChunks.GetMemoryUsage();
+        m_compressedChunks.Store(*candidate.chunk);
+        size_t cacheAfter = m_compressedChunks.GetMemoryUsage();
+
+        m_demotedChunks.insert(position);
+        OnChunkUnloaded(m_chunkGrid.Remove(position)); // Saves edits like any unload
+        total = total - chunkBytes + (cacheAfter - cacheBefore);
+        demotions--;
+    }
+
+    // Compressed -> Evicted, oldest first
+    glm::ivec3 evicted;
+    while (total > target && demotions > 0) {
+        size_t cacheBefore = m_compressedChunks.GetMemoryUsage();
+        if (!m_compressedChunks.EvictOldest(evicted)) {
+            break;
+        }
+        total -= cacheBefore - m_compressedChunks.GetMemoryUsage();
+        demotions--;
+    }
+
+    m_budgetUsage = total;
+
+    // Ran out of candidates: pull the distances in, the next frame demotes
+    // what fell outside
+    if (total > m_memoryBudget.maxBytes && demotions > 0) {
+        if (m_budgetShrink < MAX_BUDGET_SHRINK) {
+            SetBudgetShrink(m_budgetShrink + 1);
+        } else if (!m_budgetWarningShown) {
+            std::cerr << "Memory budget of " << m_memoryBudget.maxBytes / (1024 * 1024)
+                      << " MB is below what the chunks within a render distance of "
+                      << GetRenderDistance() << " need" << std::endl;
+            m_budgetWarningShown = true;
+        }
+    }
+}
+
+void ChunkManager::SetBudgetShrink(int shrink) {
+    if (shrink == m_budgetShrink) {
+        return;
+    }
+
+    std::cout << "Memory budget: render distance " << GetRenderDistance() << " -> "
+              << RENDER_DISTANCE - shrink << std::endl;
+    m_budgetShrink = shrink;
+    m_budgetGrowTime = m_time + BUDGET_GROW_DELAY;
+
+    m_chunkGrid.ForEach([this](Chunk* chunk) { UpdateChunkVisibility(chunk); });
+    m_skippedRequests = true; // Growing needs the new ring requested
+}
+
+void ChunkManager::PruneDemotedChunks() {
+    // Outside the window demoted chunks are simply unloaded
+    auto inWindow = [this](const glm::ivec3& position) { return m_chunkGrid.IsInside(position); };
+    m_compressedChunks.RemoveUnless(inWindow);
+    for (auto it = m_demotedChunks.begin(); it != m_demotedChunks.end();) {
+        if (!inWindow(*it)) {
+            it = m_demotedChunks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ChunkManager::DumpLifecycleStats(std::ostream& out) const {
+    m_lifecycle.Dump(out);
+
+    std::array<size_t, ChunkLifecycle::STATE_COUNT> counts{};
+    counts[static_cast<size_t>(ChunkState::Requested)] = m_pendingChunks.size(); // Includes Generating/Generated
+    m_chunkGrid.ForEach([&counts](const Chunk* chunk) {
+        counts[static_cast<size_t>(chunk->GetState())]++;
+    });
+
+    out << "Chunks by state:";
+    for (size_t i = 0; i < ChunkLifecycle::STATE_COUNT; ++i) {
+        if (counts[i] > 0) {
+            out << " " << ChunkLifecycle::GetStateName(static_cast<ChunkState>(i)) << "=" << counts[i];
+        }
+    }
+    out << std::endl;
+}
+
+namespace {
+    // Buckets, entries and per-node links of a node based hash container
+    template<typename Container>
+    size_t GetHashMemoryUsage(const Container& container) {
+        return container.bucket_count() * sizeof(void*) +
+               container.size() * (sizeof(typename Container::value_type) + 2 * sizeof(void*));
+    }
+}
+
+void ChunkManager::SampleQueueMemory() {
+    size_t bytes = m_generatedChunks.GetMemoryUsage() + m_columnResults.GetMemoryUsage();
+    bytes += m_generationPool->GetPendingCount() * sizeof(GenerationPool::Task);
+    bytes += m_worldStorage->GetPendingWriteCount() * sizeof(ChunkSnapshot);
+    bytes += GetHashMemoryUsage(m_pendingChunks) + GetHashMemoryUsage(m_pendingColumns);
+    bytes += GetHashMemoryUsage(m_columnBounds) + GetHashMemoryUsage(m_demotedChunks);
+    bytes += m_visibleChunks.capacity() * sizeof(Chunk*);
+    MemoryAccounting::Set(MemoryCategory::Queues, static_cast<int64_t>(bytes));
+}
+
+void ChunkManager::DumpMemoryStats(std::ostream& out) const {
+    MemoryAccounting::Dump(out);
+
+    std::vector<size_t> meshBytes;
+    meshBytes.reserve(m_chunkGrid.GetCount());
+    size_t voxelBytes = 0;
+    m_chunkGrid.ForEach([&](const Chunk* chunk) {
+        voxelBytes += chunk->GetMemoryUsage();
+        meshBytes.push_back(chunk->GetMeshMemoryUsage());
+    });
+    if (meshBytes.empty()) {
+        return;
+    }
+
+    // Voxel storage is nearly constant per chunk, the mesh is what varies
+    std::sort(meshBytes.begin(), meshBytes.end());
+    auto percentile = [&meshBytes](size_t p) {
+        return meshBytes[(meshBytes.size() - 1) * p / 100] / 1024;
+    };
+    size_t meshed = meshBytes.end() - std::upper_bound(meshBytes.begin(), meshBytes.end(), size_t(0));
+
+    out << "Per chunk (" << meshBytes.size() << " in grid, " << meshed << " meshed): voxel "
+        << voxelBytes / meshBytes.size() / 1024 << " KB, mesh p50 " << percentile(50)
+        << " KB, p90 " << percentile(90) << " KB, p99 " << percentile(99)
+        << " KB, max " << meshBytes.back() / 1024 << " KB" << std::endl;
+}
+
 size_t ChunkManager::GetGenerationQueueSize() const {
-    std::lock_guard<std::mutex> lock(m_queueMutex);
-    return m_generationQueue.size();
+    return m_generationPool->GetPendingCount();
 }
\ No newline at end of file
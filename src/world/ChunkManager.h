@@ -4,103 +4,387 @@
 
 #pragma once
 
+#include "BakedWorld.h"
 #include "Chunk.h"
+#include "ChunkGrid.h"
+#include "ChunkLifecycle.h"
+#include "ChunkPool.h"
+#include "ChunkPrefetcher.h"
+#include "CompressedChunkCache.h"
 #include "WorldGenerator.h"
+#include "GenerationPipeline.h"
+#include "GenerationPool.h"
+#include "MeshUploader.h"
+#include "WorldStorage.h"
+#include "../utils/MPSCQueue.h"
+#include "../utils/EpochReclaimer.h"
+#include "../utils/Math.h"
 #include <glm/glm.hpp>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <vector>
-#include <thread>
-#include <mutex>
 #include <queue>
 #include <atomic>
-
-// Hash function for glm::ivec3
-struct ivec3Hash {
-    std::size_t operator()(const glm::ivec3& v) const {
-        return std::hash<int>()(v.x) ^
-               (std::hash<int>()(v.y) << 1) ^
-               (std::hash<int>()(v.z) << 2);
-    }
-};
+#include <ostream>
+#include <string>
 
 class ChunkManager {
 public:
+    // How edits are persisted: as deltas over the generator output (tiny,
+    // committed every few seconds) or as whole chunk snapshots
+    enum class SaveMode {
+        EditJournal,
+        FullChunks
+    };
+
+    // Where a chunk's data lives, from most to least memory. Over the memory
+    // budget, chunks outside the promote distance are demoted one tier at a
+    // time (farthest and least recently seen first) and promoted back once the
+    // viewer comes within it again. If that isn't enough, the load, render and
+    // promote distances shrink (see MAX_BUDGET_SHRINK).
+    enum class ChunkResidency {
+        Meshed,     // In the grid with a GPU mesh
+        VoxelOnly,  // In the grid, mesh released
+        Compressed, // Out of the grid, ChunkCodec encoded in memory
+        Evicted     // Not in memory; regenerated or loaded from disk when needed
+    };
+
+    // Ceiling for chunk memory, CPU and GPU. 0 disables the budget. No new
+    // chunks are requested while over it; it holds as long as the chunks
+    // within the smallest render distance fit.
+    struct MemoryBudget {
+        size_t maxBytes = 0;
+        float lowWatermark = 0.9f; // Demotion stops at maxBytes * lowWatermark
+    };
+
+    struct MemoryUsage {
+        size_t voxelBytes = 0;      // Chunks in the grid
+        size_t meshBytes = 0;       // GPU vertex/index buffers of chunks in the grid
+        size_t compressedBytes = 0; // Compressed tier
+        size_t pooledBytes = 0;     // Recycled chunks waiting in the pool (incl. their GPU buffers)
+
+        size_t GetTotal() const { return voxelBytes + meshBytes + compressedBytes + pooledBytes; }
+    };
+
     static constexpr int RENDER_DISTANCE = 8;
     static constexpr int LOAD_DISTANCE = RENDER_DISTANCE + 2;
     static constexpr int UNLOAD_DISTANCE = LOAD_DISTANCE + 2;
+    static constexpr int VERTICAL_LOAD_DISTANCE = 2;
+
+    // Vertical streaming is column aware: besides the band around the viewer,
+    // each column loads the chunks holding its surface (mountains, trees) up
+    // to MAX_VERTICAL_DISTANCE. Chunks the column bounds prove all Air are
+    // never loaded; solid stone chunks below every surface only load within
+    // BURIED_LOAD_DISTANCE of the viewer, where digging can reach them.
+    static constexpr int MAX_VERTICAL_DISTANCE = 5;
+    static constexpr int BURIED_LOAD_DISTANCE = 1;
+    static constexpr int VERTICAL_UNLOAD_DISTANCE = MAX_VERTICAL_DISTANCE + 1;
+
+    // Chunks past the unload distance are only unloaded after UNLOAD_DELAY
+    // seconds out of range, so a viewer hovering at the edge doesn't make the
+    // same ring load and unload over and over. The chunk window is the hard
+    // limit - anything that falls out of it is unloaded at once.
+    static constexpr float UNLOAD_DELAY = 5.0f;
+    static constexpr int WINDOW_MARGIN = 2;
+
+    // Chunks this close to the viewer count towards prefetch hit/miss stats
+    static constexpr int NEAR_DISTANCE = 3;
+
+    // Demoted chunks come back within this distance, only chunks beyond it are demoted
+    static constexpr int PROMOTE_DISTANCE = RENDER_DISTANCE + 1;
+    // Over the memory budget with nothing left to demote, the load, render and
+    // promote distances shrink by one chunk per frame, down to this many
+    // chunks less. They grow back one step per BUDGET_GROW_DELAY seconds while
+    // usage stays below BUDGET_GROW_WATERMARK of the budget.
+    static constexpr int MAX_BUDGET_SHRINK = RENDER_DISTANCE - 2;
+    static constexpr float BUDGET_GROW_DELAY = 5.0f;
+    static constexpr float BUDGET_GROW_WATERMARK = 0.6f;
+    // Demotion order: one chunk of distance weighs as much as this many seconds unseen
+    static constexpr float LRU_SECONDS_PER_CHUNK = 10.0f;
 
-    ChunkManager();
+    // Per-frame budgets for main thread work
+    static constexpr int MAX_CHUNKS_PER_FRAME = 32;        // Generated chunks taken from the workers
+    static constexpr int MAX_MESH_UPDATES_PER_FRAME = 16;  // Dirty chunks re-meshed
+    static constexpr int MAX_UNLOADS_PER_FRAME = 64;       // Timed-out chunks unloaded
+    static constexpr size_t MAX_RELEASES_PER_FRAME = 64;   // Retired chunks returned to the pool
+    static constexpr size_t MAX_DESTROYS_PER_FRAME = 8;    // Surplus chunks destroyed (GL deletes)
+    static constexpr int MAX_DEMOTIONS_PER_FRAME = 64;     // Residency demotions under memory pressure
+    static constexpr int MAX_COLUMNS_PER_FRAME = 64;        // Column bounds taken from the workers
+    static constexpr size_t GENERATED_QUEUE_CAPACITY = 1024;
+    static constexpr size_t COLUMN_QUEUE_CAPACITY = 1024;
+
+    static constexpr float AUTOSAVE_INTERVAL = 30.0f; // Seconds between full chunk saves
+    static constexpr const char* DEFAULT_WORLD_DIRECTORY = "saves/world";
+
+    // Meshes go to the GPU through meshUploader (a NullMeshUploader runs the
+    // world without a window). generationThreads == 0 sizes the generation
+    // pool from hardware concurrency.
+    explicit ChunkManager(std::unique_ptr<MeshUploader> meshUploader, uint32_t generationThreads = 0);
     ~ChunkManager();
 
-    void Initialize();
-    void Update(const glm::vec3& viewerPosition, float deltaTime);
+    void Initialize(const std::string& worldDirectory = DEFAULT_WORLD_DIRECTORY);
+
+    // Streams terrain from a pre-baked world file instead of the generator.
+    // Call before Initialize().
+    bool OpenBakedWorld(const std::string& path);
+    bool IsUsingBakedWorld() const { return m_bakedWorld.IsOpen(); }
+    // viewDirection steers predictive loading (see ChunkPrefetcher)
+    void Update(const glm::vec3& viewerPosition, const glm::vec3& viewDirection, float deltaTime);
+
+    void SetPrefetchSettings(const PrefetchSettings& settings) { m_prefetcher.SetSettings(settings); }
+    const ChunkPrefetcher& GetPrefetcher() const { return m_prefetcher; }
 
-    // Chunk access
-    Chunk* GetChunk(const glm::ivec3& position);
-    std::vector<Chunk*> GetVisibleChunks() const;
+    // Lock-free chunk access from any thread.
+    // Unloaded chunks are only freed on the main thread once no reader can see
+    // them, so other threads must hold a read guard while using the pointer.
+    Chunk* GetChunk(const glm::ivec3& position) const { return m_chunkGrid.Get(position); }
+    EpochReclaimer::Guard AcquireReadGuard() const { return m_reclaimer.Pin(); }
 
-    // Block access through world coordinates
-    BlockType GetBlock(int x, int y, int z);
+    // Non-empty chunks within RENDER_DISTANCE, maintained incrementally.
+    // Main thread only; valid until the next Update().
+    const std::vector<Chunk*>& GetVisibleChunks() const { return m_visibleChunks; }
+
+    // Block access through world coordinates. SetBlock is main thread only,
+    // GetBlock any thread: the epoch guard keeps the chunk alive, and writes to
+    // a chunk in the grid (SetBlock, palette compaction while meshing) swap in
+    // a new copy of its block data instead of changing it in place.
+    BlockType GetBlock(int x, int y, int z) const;
     void SetBlock(int x, int y, int z, BlockType type);
 
+    // Region access (any thread, like GetBlock). Both walk the box chunk by
+    // chunk, resolving each chunk once; blocks of unloaded chunks read as Air.
+    // CopyRegion reads each chunk from one version of its block data;
+    // VisitRegion reads block by block, so a concurrent SetBlock can show up
+    // part way through the walk.
+    // CopyRegion fills out with the inclusive box [min, max], X fastest, then Z, then Y
+    // (the same order as chunk storage). out must hold GetRegionVolume(min, max) entries.
+    void CopyRegion(const glm::ivec3& min, const glm::ivec3& max, BlockType* out) const;
+    static size_t GetRegionVolume(const glm::ivec3& min, const glm::ivec3& max);
+
+    // Calls visitor(const glm::ivec3& worldPos, BlockType type) for every block in [min, max]
+    template<typename Visitor>
+    void VisitRegion(const glm::ivec3& min, const glm::ivec3& max, Visitor&& visitor) const;
+
+    void SetMemoryBudget(const MemoryBudget& budget) { m_memoryBudget = budget; }
+    const MemoryBudget& GetMemoryBudget() const { return m_memoryBudget; }
+    // LOAD_DISTANCE / RENDER_DISTANCE minus what the memory budget took off
+    int GetLoadDistance() const { return LOAD_DISTANCE - m_budgetShrink; }
+    int GetRenderDistance() const { return RENDER_DISTANCE - m_budgetShrink; }
+    MemoryUsage GetMemoryUsage() const; // Main thread only
+    ChunkResidency GetResidency(const glm::ivec3& position) const;
+    size_t GetCompressedChunkCount() const { return m_compressedChunks.GetCount(); }
+
+    // Queues every edited chunk for saving and waits until it is on disk
+    void SaveWorld();
+    void SetSaveMode(SaveMode mode) { m_saveMode = mode; }
+    SaveMode GetSaveMode() const { return m_saveMode; }
+
     // Statistics
     size_t GetLoadedChunkCount() const;
+    const ChunkPool& GetChunkPool() const { return m_chunkPool; }
+    const WorldStorage& GetWorldStorage() const { return *m_worldStorage; }
+    const WorldGenerator& GetWorldGenerator() const { return *m_worldGenerator; }
+    const GenerationPipeline& GetGenerationPipeline() const { return *m_generationPipeline; }
     size_t GetTotalMemoryUsage() const;
 
+    // Per-stage latency from request to visible; safe to read from any thread
+    const ChunkLifecycle& GetLifecycle() const { return m_lifecycle; }
+    // Latency histograms plus how many chunks are in each state right now (main thread)
+    void DumpLifecycleStats(std::ostream& out) const;
+    // Current and peak bytes per memory category plus the per-chunk distribution (main thread)
+    void DumpMemoryStats(std::ostream& out) const;
+
+    // Column culling results of the last load pass
+    size_t GetSkippedEmptyChunkCount() const { return m_skippedEmptyChunks; }
+    size_t GetDeferredBuriedChunkCount() const { return m_deferredBuriedChunks; }
+
     // Generation status
-    bool IsGenerationComplete() const { return m_generationQueue.empty(); }
+    bool IsGenerationComplete() const { return m_pendingChunks.empty() && m_pendingColumns.empty(); }
     size_t GetGenerationQueueSize() const;
+    uint32_t GetGenerationThreadCount() const { return m_generationPool->GetWorkerCount(); }
 
 private:
+    // Chunk loading priority
+    struct ChunkLoadRequest {
+        glm::ivec3 position;
+        float priority; // Distance re-weighted by the prefetcher
+
+        bool operator<(const ChunkLoadRequest& other) const {
+            return priority > other.priority; // Min heap (most urgent first)
+        }
+    };
+
     // Coordinate conversion
     glm::ivec3 WorldToChunkPosition(const glm::vec3& worldPos) const;
-    glm::ivec3 WorldToBlockPosition(int x, int y, int z) const;
-    glm::ivec3 GetChunkPositionFromBlock(int x, int y, int z) const;
+    static glm::ivec3 WorldToBlockPosition(int x, int y, int z) {
+        return glm::ivec3(Math::FloorMod(x, Chunk::SIZE), Math::FloorMod(y, Chunk::HEIGHT), Math::FloorMod(z, Chunk::SIZE));
+    }
+    static glm::ivec3 GetChunkPositionFromBlock(int x, int y, int z) {
+        return glm::ivec3(Math::FloorDiv(x, Chunk::SIZE), Math::FloorDiv(y, Chunk::HEIGHT), Math::FloorDiv(z, Chunk::SIZE));
+    }
 
     // Chunk management
     void LoadChunksAroundPosition(const glm::ivec3& centerChunk);
+    bool IsColumnInLoadRange(const glm::ivec2& column, const glm::ivec3& centerChunk) const;
+    // False when the column's bounds aren't known yet (nothing queued, see RequestColumnBounds)
+    bool QueueColumnChunks(const glm::ivec2& column, const glm::ivec3& centerChunk,
+                           std::priority_queue<ChunkLoadRequest>& loadQueue);
     void UnloadDistantChunks(const glm::ivec3& centerChunk);
-    void LoadChunk(const glm::ivec3& position);
-    void UpdateChunkNeighbors(const glm::ivec3& position);
+    bool IsInUnloadRange(const glm::ivec3& chunkPosition, const glm::ivec3& centerChunk) const;
+    void RecordPrefetchArrivals(const glm::ivec3& oldCenter, const glm::ivec3& newCenter);
+    void UpdateChunkNeighbors(Chunk* chunk);
+    void UnlinkChunkNeighbors(Chunk* chunk);
+    void OnChunkUnloaded(std::unique_ptr<Chunk> chunk);
+
+    // Visible set maintenance
+    bool IsInRenderDistance(const glm::ivec3& chunkPosition) const;
+    void UpdateChunkVisibility(Chunk* chunk);
+    void RemoveFromVisible(Chunk* chunk);
 
     // Mesh generation in main thread
     void UpdateChunkMeshes();
 
-    // Generation thread
-    void GenerationThreadFunc();
+    // Generation (runs on pool workers)
+    void GenerateChunkTask(const glm::ivec3& position);
     void RequestChunkGeneration(const glm::ivec3& position);
 
-    // Chunk storage
-    std::unordered_map<glm::ivec3, std::unique_ptr<Chunk>, ivec3Hash> m_chunks;
-    mutable std::mutex m_chunksMutex;
+    // Column bounds, computed on the workers and cached on the main thread
+    bool UsesColumnCulling() const { return !m_bakedWorld.IsOpen(); }
+    void RequestColumnBounds(const glm::ivec2& column);
+    void ProcessColumnBounds();
+    void PruneColumnBounds();
+    bool HasStoredData(const glm::ivec3& position) const;
+    // Kept out by column culling on purpose: Empty, or Buried beyond
+    // BURIED_LOAD_DISTANCE of center (main thread)
+    bool IsCulledByColumn(const glm::ivec3& position, const glm::ivec3& center) const;
+
+    // Edits into a chunk skipped as all Air create it on the spot
+    Chunk* CreateEmptyChunk(const glm::ivec3& position);
+
+    // Memory budget: demotes chunks through the residency tiers
+    void EnforceMemoryBudget();
+    void SetBudgetShrink(int shrink);
+    // No new chunks or meshes while set
+    bool IsBudgetFull() const { return m_memoryBudget.maxBytes > 0 && m_budgetUsage > m_memoryBudget.maxBytes; }
+    bool IsInPromoteDistance(const glm::ivec3& chunkPosition) const;
+    void PruneDemotedChunks();
+    void DecodeChunkTask(const glm::ivec3& position, const std::vector<uint8_t>& data);
+
+    // Queue sizes change at every push, so they are measured once per frame
+    void SampleQueueMemory();
+
+    // Persistence. Loads are answered on the storage I/O thread.
+    void OnChunkLoaded(const glm::ivec3& position, std::unique_ptr<Chunk> chunk);
+    void SaveChunk(Chunk* chunk);
+    void SaveModifiedChunks();
+
+    // Hands a finished chunk to the main thread (any thread)
+    void PublishChunk(std::unique_ptr<Chunk> chunk);
+
+    // Declared before anything holding chunks: chunk destructors release their meshes here
+    std::unique_ptr<MeshUploader> m_meshUploader;
+
+    // Mapped baked terrain; declared early so chunks referencing it are gone before it unmaps
+    BakedWorld m_bakedWorld;
+
+    // Chunk storage: dense window around the viewer, mutated on the main thread only.
+    // Removed chunks are unlinked at once, then go through the reclaimer (so
+    // concurrent readers never see freed memory) and back to the pool for
+    // reuse; both steps are budgeted per frame.
+    ChunkPool m_chunkPool;
+    mutable EpochReclaimer m_reclaimer;
+    ChunkGrid m_chunkGrid{UNLOAD_DISTANCE + WINDOW_MARGIN, VERTICAL_UNLOAD_DISTANCE + WINDOW_MARGIN};
+
+    // Chunks the renderer should consider; each chunk knows its own index
+    std::vector<Chunk*> m_visibleChunks;
 
     // World generator
     std::unique_ptr<WorldGenerator> m_worldGenerator;
 
-    // Generation queue and thread
-    std::queue<glm::ivec3> m_generationQueue;
-    std::queue<std::unique_ptr<Chunk>> m_generatedChunks;
-    mutable std::mutex m_queueMutex;
-    std::mutex m_generatedMutex;
-    std::thread m_generationThread;
+    // On-disk chunks; edited chunks are saved on unload and periodically
+    std::unique_ptr<WorldStorage> m_worldStorage;
+    SaveMode m_saveMode = SaveMode::EditJournal;
+    float m_autosaveTimer = 0.0f;
+
+    // Generation workers and their output (workers produce, main thread consumes)
+    std::unique_ptr<GenerationPool> m_generationPool;
+    std::unique_ptr<GenerationPipeline> m_generationPipeline; // Generator stages on the pool
+    MPSCQueue<std::unique_ptr<Chunk>> m_generatedChunks{GENERATED_QUEUE_CAPACITY};
     std::atomic<bool> m_shouldStop{false};
 
+    // Positions requested but not yet in the grid, with the request time (main thread only)
+    std::unordered_map<glm::ivec3, Chunk::TimePoint, ivec3Hash> m_pendingChunks;
+    ChunkLifecycle m_lifecycle;
+
+    // Column height bounds for the chunk window (main thread only).
+    // A column's chunks are requested once its bounds arrive.
+    struct ColumnBoundsResult {
+        glm::ivec2 column{0};
+        WorldGenerator::ColumnBounds bounds;
+    };
+    std::unordered_map<glm::ivec2, WorldGenerator::ColumnBounds, ivec2Hash> m_columnBounds;
+    std::unordered_set<glm::ivec2, ivec2Hash> m_pendingColumns;
+    MPSCQueue<ColumnBoundsResult> m_columnResults{COLUMN_QUEUE_CAPACITY};
+    size_t m_skippedEmptyChunks = 0;
+    size_t m_deferredBuriedChunks = 0;
+
+    // Residency below VoxelOnly (main thread only). Demoted positions - compressed
+    // or evicted - aren't requested again until within the promote distance.
+    MemoryBudget m_memoryBudget;
+    CompressedChunkCache m_compressedChunks;
+    std::unordered_set<glm::ivec3, ivec3Hash> m_demotedChunks;
+    bool m_budgetWarningShown = false;
+    int m_budgetShrink = 0;          // Chunks taken off the load/render/promote distances
+    size_t m_budgetUsage = 0;        // Measured by EnforceMemoryBudget, plus chunks and meshes added since
+    bool m_skippedRequests = false;  // Requests skipped while full; rescan once there is room
+    float m_budgetGrowTime = 0.0f;   // m_time from which the distances may grow again
+
     // Current viewer position
-    glm::ivec3 m_currentChunkPosition;
-    glm::vec3 m_lastViewerPosition;
+    glm::ivec3 m_currentChunkPosition{0};
+    glm::vec3 m_lastViewerPosition{0.0f};
+
+    // Travel prediction; the load region also covers LOAD_DISTANCE around
+    // the predicted chunk (current chunk + offset)
+    ChunkPrefetcher m_prefetcher;
+    glm::ivec3 m_predictedChunkOffset{0};
 
     // Performance tracking
+    float m_time = 0.0f; // Seconds since start, drives unload hysteresis
     float m_updateTimer = 0.0f;
     static constexpr float UPDATE_INTERVAL = 0.1f; // Update chunks every 100ms
+};
 
-    // Chunk loading priority
-    struct ChunkLoadRequest {
-        glm::ivec3 position;
-        float distance;
+template<typename Visitor>
+void ChunkManager::VisitRegion(const glm::ivec3& min, const glm::ivec3& max, Visitor&& visitor) const {
+    const glm::ivec3 chunkMin = GetChunkPositionFromBlock(min.x, min.y, min.z);
+    const glm::ivec3 chunkMax = GetChunkPositionFromBlock(max.x, max.y, max.z);
+    const glm::ivec3 chunkSize(Chunk::SIZE, Chunk::HEIGHT, Chunk::SIZE);
 
-        bool operator<(const ChunkLoadRequest& other) const {
-            return distance > other.distance; // Min heap (closest first)
+    EpochReclaimer::Guard guard = m_reclaimer.Pin();
+
+    for (int cy = chunkMin.y; cy <= chunkMax.y; ++cy) {
+        for (int cz = chunkMin.z; cz <= chunkMax.z; ++cz) {
+            for (int cx = chunkMin.x; cx <= chunkMax.x; ++cx) {
+                const glm::ivec3 chunkPos(cx, cy, cz);
+                const Chunk* chunk = m_chunkGrid.Get(chunkPos);
+
+                // Part of the region covered by this chunk, in world coordinates
+                const glm::ivec3 origin = chunkPos * chunkSize;
+                const glm::ivec3 from = glm::max(min, origin);
+                const glm::ivec3 to = glm::min(max, origin + chunkSize - glm::ivec3(1));
+
+                for (int y = from.y; y <= to.y; ++y) {
+                    for (int z = from.z; z <= to.z; ++z) {
+                        for (int x = from.x; x <= to.x; ++x) {
+                            BlockType type = chunk
+                                ? chunk->GetBlockUnchecked(x - origin.x, y - origin.y, z - origin.z)
+                                : BlockType::Air;
+                            visitor(glm::ivec3(x, y, z), type);
+                        }
+                    }
+                }
+            }
         }
-    };
-};
\ No newline at end of file
+    }
+}
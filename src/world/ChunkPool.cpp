@@ -0,0 +1,79 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "ChunkPool.h"
+#include <algorithm>
+#include <iterator>
+
+ChunkPool::ChunkPool(size_t maxPooled)
+    : m_maxPooled(maxPooled) {
+    m_freeChunks.reserve(maxPooled);
+}
+
+ChunkPool::~ChunkPool() = default;
+
+std::unique_ptr<Chunk> ChunkPool::Acquire(const glm::ivec3& position) {
+    std::unique_ptr<Chunk> chunk;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_freeChunks.empty()) {
+            chunk = std::move(m_freeChunks.back());
+            m_freeChunks.pop_back();
+        }
+    }
+
+    if (chunk) {
+        chunk->Reset(position);
+        m_reused.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        chunk = std::make_unique<Chunk>(position);
+        m_allocated.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return chunk;
+}
+
+void ChunkPool::Release(std::unique_ptr<Chunk> chunk) {
+    if (!chunk) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_freeChunks.push_back(std::move(chunk));
+}
+
+size_t ChunkPool::Trim(size_t maxDestroyed) {
+    return Shrink(m_maxPooled, maxDestroyed);
+}
+
+size_t ChunkPool::Shrink(size_t keep, size_t maxDestroyed) {
+    std::vector<std::unique_ptr<Chunk>> surplus;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_freeChunks.size() <= keep) {
+            return 0;
+        }
+
+        size_t count = std::min(m_freeChunks.size() - keep, maxDestroyed);
+        surplus.assign(std::make_move_iterator(m_freeChunks.end() - count),
+                       std::make_move_iterator(m_freeChunks.end()));
+        m_freeChunks.resize(m_freeChunks.size() - count);
+    }
+    // Surplus chunks (and their GPU objects) are destroyed here, outside the lock
+    return surplus.size();
+}
+
+size_t ChunkPool::GetPooledCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_freeChunks.size();
+}
+
+size_t ChunkPool::GetMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t total = m_freeChunks.capacity() * sizeof(std::unique_ptr<Chunk>);
+    for (const auto& chunk : m_freeChunks) {
+        total += chunk->GetMemoryUsage() + chunk->GetMeshMemoryUsage();
+    }
+    return total;
+}
@@ -0,0 +1,49 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "Chunk.h"
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Recycles Chunk objects (and the GPU buffers they own) across load/unload
+// cycles, so steady-state streaming doesn't allocate chunks or GPU objects.
+class ChunkPool {
+public:
+    explicit ChunkPool(size_t maxPooled = 4096);
+    ~ChunkPool();
+
+    // Any thread. Returns a reset chunk at the given position.
+    std::unique_ptr<Chunk> Acquire(const glm::ivec3& position);
+
+    // Any thread. Never destroys the chunk itself (that would delete GPU
+    // objects), surplus chunks are freed by Trim().
+    void Release(std::unique_ptr<Chunk> chunk);
+
+    // Main thread only. Destroys up to maxDestroyed pooled chunks beyond
+    // maxPooled (each one deletes GPU objects), returns how many were destroyed.
+    size_t Trim(size_t maxDestroyed = SIZE_MAX);
+
+    // Main thread only. Like Trim() but keeps at most 'keep' chunks, for memory pressure.
+    size_t Shrink(size_t keep, size_t maxDestroyed = SIZE_MAX);
+
+    // Statistics
+    size_t GetPooledCount() const;
+    size_t GetMemoryUsage() const; // Pooled chunk objects and the GPU buffers they keep
+    size_t GetAllocatedCount() const { return m_allocated.load(std::memory_order_relaxed); }
+    size_t GetReusedCount() const { return m_reused.load(std::memory_order_relaxed); }
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<Chunk>> m_freeChunks;
+    size_t m_maxPooled;
+
+    std::atomic<size_t> m_allocated{0};
+    std::atomic<size_t> m_reused{0};
+};
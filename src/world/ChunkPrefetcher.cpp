@@ -0,0 +1,101 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "ChunkPrefetcher.h"
+#include <algorithm>
+#include <iostream>
+
+ChunkPrefetcher::ChunkPrefetcher(const PrefetchSettings& settings)
+    : m_settings(settings) {
+}
+
+void ChunkPrefetcher::Update(const glm::vec3& position, const glm::vec3& forward, float deltaTime) {
+    if (glm::length(forward) > 0.0f) {
+        m_forward = glm::normalize(forward);
+    }
+
+    if (!m_hasPosition || deltaTime <= 0.0f) {
+        m_lastPosition = position;
+        m_hasPosition = true;
+        return;
+    }
+
+    // Smoothed so a single long frame or a jitter doesn't swing the prediction
+    glm::vec3 velocity = (position - m_lastPosition) / deltaTime;
+    m_velocity += (velocity - m_velocity) * m_settings.velocitySmoothing;
+    m_lastPosition = position;
+
+    // Log hit/miss rates periodically
+    m_statsTimer += deltaTime;
+    if (m_settings.statsInterval > 0.0f && m_statsTimer >= m_settings.statsInterval) {
+        m_statsTimer = 0.0f;
+
+        uint32_t arrivals = m_intervalHits + m_intervalMisses;
+        if (arrivals > 0) {
+            std::cout << "Prefetch: " << m_intervalHits << "/" << arrivals << " chunks ready on arrival ("
+                      << (100.0f * m_intervalHits / arrivals) << "%), total " << GetHitRate() * 100.0f
+                      << "%, " << m_prefetchRequests << " predictive requests" << std::endl;
+        }
+        m_intervalHits = 0;
+        m_intervalMisses = 0;
+    }
+}
+
+glm::vec3 ChunkPrefetcher::GetTravelDirection() const {
+    float speed = glm::length(m_velocity);
+    if (speed < m_settings.minSpeed) {
+        return glm::vec3(0.0f);
+    }
+
+    // Mostly where we're going, nudged towards where we're looking
+    glm::vec3 direction = glm::normalize(m_velocity) * (1.0f - m_settings.viewWeight) + m_forward * m_settings.viewWeight;
+    float length = glm::length(direction);
+    return length > 0.0f ? direction / length : glm::vec3(0.0f);
+}
+
+glm::vec3 ChunkPrefetcher::GetPredictedOffset(const glm::vec3& chunkSize) const {
+    if (!m_settings.enabled || glm::length(m_velocity) < m_settings.minSpeed) {
+        return glm::vec3(0.0f);
+    }
+
+    glm::vec3 offset = m_velocity * m_settings.lookaheadTime / chunkSize;
+    float length = glm::length(offset);
+    if (length > m_settings.maxLookahead) {
+        offset *= m_settings.maxLookahead / length;
+    }
+    return offset;
+}
+
+float ChunkPrefetcher::GetPriority(const glm::vec3& offset) const {
+    // Vertical distance counts double - terrain is mostly spread horizontally
+    float distance = glm::length(glm::vec3(offset.x, offset.y * 2.0f, offset.z));
+    if (!m_settings.enabled || distance == 0.0f) {
+        return distance;
+    }
+
+    glm::vec3 direction = GetTravelDirection();
+    if (direction == glm::vec3(0.0f)) {
+        direction = m_forward; // Standing still: prefer what's in view
+    }
+
+    // +1 straight ahead, -1 straight behind
+    float alignment = glm::dot(offset / glm::length(offset), direction);
+    float scale = alignment >= 0.0f
+        ? 1.0f - (1.0f - m_settings.aheadBonus) * alignment
+        : 1.0f + (m_settings.behindPenalty - 1.0f) * -alignment;
+
+    return distance * scale;
+}
+
+void ChunkPrefetcher::RecordArrivals(uint32_t hits, uint32_t misses) {
+    m_totalHits += hits;
+    m_totalMisses += misses;
+    m_intervalHits += hits;
+    m_intervalMisses += misses;
+}
+
+float ChunkPrefetcher::GetHitRate() const {
+    uint64_t total = m_totalHits + m_totalMisses;
+    return total > 0 ? static_cast<float>(m_totalHits) / total : 1.0f;
+}
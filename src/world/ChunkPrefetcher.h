@@ -0,0 +1,71 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+// Tunables for predictive chunk loading
+struct PrefetchSettings {
+    bool enabled = true;
+    float lookaheadTime = 1.5f;      // Seconds of travel to load ahead
+    float maxLookahead = 4.0f;       // Cap on the predicted offset, in chunks
+    float minSpeed = 4.0f;           // Blocks per second below which nothing is predicted
+    float velocitySmoothing = 0.15f; // Exponential smoothing factor per frame (0..1)
+    float viewWeight = 0.35f;        // How much the view direction steers the travel direction
+    float aheadBonus = 0.5f;         // Priority distance scale for chunks straight ahead (0..1)
+    float behindPenalty = 2.0f;      // Priority distance scale for chunks straight behind (>= 1)
+    float statsInterval = 10.0f;     // Seconds between hit/miss log lines, 0 disables logging
+};
+
+// Predicts where the viewer is heading from its smoothed velocity and view
+// direction. ChunkManager uses it to extend the load region along the travel
+// direction and to order load requests. Hit/miss counters measure how many
+// chunks were already loaded when the viewer got close to them.
+class ChunkPrefetcher {
+public:
+    explicit ChunkPrefetcher(const PrefetchSettings& settings = PrefetchSettings());
+
+    void SetSettings(const PrefetchSettings& settings) { m_settings = settings; }
+    const PrefetchSettings& GetSettings() const { return m_settings; }
+
+    // Once per frame with the viewer position (world units) and view direction
+    void Update(const glm::vec3& position, const glm::vec3& forward, float deltaTime);
+
+    // Offset of the predicted viewer chunk from the current one, in chunks
+    glm::vec3 GetPredictedOffset(const glm::vec3& chunkSize) const;
+
+    // Load priority of a chunk at 'offset' chunks from the viewer chunk (lower loads first)
+    float GetPriority(const glm::vec3& offset) const;
+
+    // Chunks that entered the near region around the viewer, split by whether
+    // they were already loaded (hit) or not (miss / pop-in)
+    void RecordArrivals(uint32_t hits, uint32_t misses);
+
+    const glm::vec3& GetVelocity() const { return m_velocity; }
+    uint64_t GetHitCount() const { return m_totalHits; }
+    uint64_t GetMissCount() const { return m_totalMisses; }
+    float GetHitRate() const;
+
+    void CountPrefetchRequest() { m_prefetchRequests++; }
+    uint64_t GetPrefetchRequestCount() const { return m_prefetchRequests; }
+
+private:
+    glm::vec3 GetTravelDirection() const;
+
+    PrefetchSettings m_settings;
+
+    glm::vec3 m_lastPosition{0.0f};
+    glm::vec3 m_velocity{0.0f};
+    glm::vec3 m_forward{0.0f, 0.0f, -1.0f};
+    bool m_hasPosition = false;
+
+    uint64_t m_totalHits = 0;
+    uint64_t m_totalMisses = 0;
+    uint64_t m_prefetchRequests = 0;
+    uint32_t m_intervalHits = 0;
+    uint32_t m_intervalMisses = 0;
+    float m_statsTimer = 0.0f;
+};
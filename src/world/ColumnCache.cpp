@@ -0,0 +1,79 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "ColumnCache.h"
+#include "../utils/MemoryAccounting.h"
+
+ColumnCache::ColumnCache(size_t capacity)
+    : m_capacity(capacity > 0 ? capacity : 1) {
+}
+
+ColumnCache::~ColumnCache() {
+    Clear();
+}
+
+std::shared_ptr<const ColumnCache::Sample> ColumnCache::Find(const glm::ivec2& column) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(column);
+    if (it == m_entries.end()) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    m_order.splice(m_order.begin(), m_order, it->second.order);
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return it->second.sample;
+}
+
+bool ColumnCache::Contains(const glm::ivec2& column) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.count(column) > 0;
+}
+
+std::shared_ptr<const ColumnCache::Sample> ColumnCache::Insert(const glm::ivec2& column,
+                                                               std::shared_ptr<const Sample> sample) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Two threads sampled the same column; both results are identical
+    auto it = m_entries.find(column);
+    if (it != m_entries.end()) {
+        return it->second.sample;
+    }
+
+    if (m_entries.size() >= m_capacity) {
+        auto oldest = m_entries.find(m_order.back());
+        MemoryAccounting::Add(MemoryCategory::GeneratorCaches, -static_cast<int64_t>(oldest->second.bytes));
+        m_entries.erase(oldest);
+        m_order.pop_back();
+    }
+
+    const size_t bytes = GetEntryBytes(*sample);
+    m_order.push_front(column);
+    m_entries.emplace(column, Entry{sample, m_order.begin(), bytes});
+    MemoryAccounting::Add(MemoryCategory::GeneratorCaches, static_cast<int64_t>(bytes));
+    return sample;
+}
+
+void ColumnCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int64_t bytes = 0;
+    for (const auto& [column, entry] : m_entries) {
+        bytes += static_cast<int64_t>(entry.bytes);
+    }
+    MemoryAccounting::Add(MemoryCategory::GeneratorCaches, -bytes);
+    m_entries.clear();
+    m_order.clear();
+}
+
+size_t ColumnCache::GetCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+float ColumnCache::GetHitRate() const {
+    uint64_t hits = GetHitCount();
+    uint64_t total = hits + GetMissCount();
+    return total > 0 ? static_cast<float>(hits) / total : 0.0f;
+}
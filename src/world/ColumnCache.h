@@ -0,0 +1,70 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "WorldGenerator.h"
+#include "../utils/Math.h"
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// Column samples (terrain height, biome) shared by every vertical chunk of a
+// column and by the column bounds query. Bounded by LRU; evicted samples stay
+// alive for as long as a generator thread still holds them.
+class ColumnCache {
+public:
+    using Sample = WorldGenerator::ColumnSample;
+
+    explicit ColumnCache(size_t capacity = 1024);
+    ~ColumnCache();
+
+    ColumnCache(const ColumnCache&) = delete;
+    ColumnCache& operator=(const ColumnCache&) = delete;
+
+    // Any thread. nullptr on a miss.
+    std::shared_ptr<const Sample> Find(const glm::ivec2& column);
+
+    // Any thread. Doesn't count as a use or a hit/miss.
+    bool Contains(const glm::ivec2& column) const;
+
+    // Any thread. When another thread inserted the column first, its sample
+    // is kept and returned instead.
+    std::shared_ptr<const Sample> Insert(const glm::ivec2& column, std::shared_ptr<const Sample> sample);
+
+    void Clear();
+
+    // Statistics
+    size_t GetCount() const;
+    uint64_t GetHitCount() const { return m_hits.load(std::memory_order_relaxed); }
+    uint64_t GetMissCount() const { return m_misses.load(std::memory_order_relaxed); }
+    float GetHitRate() const;
+
+private:
+    // Hash and list nodes of an entry
+    static constexpr size_t ENTRY_OVERHEAD = 96;
+
+    // Sample, its tree sites on the heap and the entry overhead
+    static size_t GetEntryBytes(const Sample& sample) {
+        return sizeof(Sample) + sample.trees.capacity() * sizeof(WorldGenerator::TreeSite) + ENTRY_OVERHEAD;
+    }
+
+    struct Entry {
+        std::shared_ptr<const Sample> sample;
+        std::list<glm::ivec2>::iterator order;
+        size_t bytes; // Accounted when inserted, given back when evicted
+    };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<glm::ivec2, Entry, ivec2Hash> m_entries;
+    std::list<glm::ivec2> m_order; // Most recently used first
+    size_t m_capacity;
+
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+};
@@ -0,0 +1,60 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "CompressedChunkCache.h"
+#include "ChunkCodec.h"
+#include "../utils/MemoryAccounting.h"
+
+CompressedChunkCache::~CompressedChunkCache() {
+    MemoryAccounting::Add(MemoryCategory::CompressedData, -static_cast<int64_t>(m_bytes));
+}
+
+void CompressedChunkCache::Store(const Chunk& chunk) {
+    auto existing = m_entries.find(chunk.GetPosition());
+    if (existing != m_entries.end()) {
+        Erase(existing);
+    }
+
+    ChunkSnapshot snapshot;
+    snapshot.Capture(chunk);
+
+    Entry entry;
+    ChunkCodec::Encode(snapshot, entry.data);
+    entry.data.shrink_to_fit();
+    entry.bytes = entry.data.capacity() + ENTRY_OVERHEAD;
+    entry.stamp = m_nextStamp++;
+
+    m_bytes += entry.bytes;
+    MemoryAccounting::Add(MemoryCategory::CompressedData, entry.bytes);
+    m_order.emplace(entry.stamp, chunk.GetPosition());
+    m_entries.emplace(chunk.GetPosition(), std::move(entry));
+}
+
+bool CompressedChunkCache::Take(const glm::ivec3& position, std::vector<uint8_t>& data) {
+    auto it = m_entries.find(position);
+    if (it == m_entries.end()) {
+        return false;
+    }
+
+    data = std::move(it->second.data);
+    Erase(it);
+    return true;
+}
+
+bool CompressedChunkCache::EvictOldest(glm::ivec3& position) {
+    if (m_order.empty()) {
+        return false;
+    }
+
+    position = m_order.begin()->second;
+    Erase(m_entries.find(position));
+    return true;
+}
+
+void CompressedChunkCache::Erase(std::unordered_map<glm::ivec3, Entry, ivec3Hash>::iterator it) {
+    m_bytes -= it->second.bytes;
+    MemoryAccounting::Add(MemoryCategory::CompressedData, -static_cast<int64_t>(it->second.bytes));
+    m_order.erase(it->second.stamp);
+    m_entries.erase(it);
+}
@@ -0,0 +1,70 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "Chunk.h"
+#include "../utils/Math.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+// Chunks demoted out of the grid under memory pressure, kept ChunkCodec
+// encoded. An entry is a fraction of a live chunk and decodes far faster
+// than the chunk generates. Main thread only.
+class CompressedChunkCache {
+public:
+    CompressedChunkCache() = default;
+    ~CompressedChunkCache();
+
+    CompressedChunkCache(const CompressedChunkCache&) = delete;
+    CompressedChunkCache& operator=(const CompressedChunkCache&) = delete;
+
+    // Encodes the chunk's blocks; replaces an older entry for the same position
+    void Store(const Chunk& chunk);
+
+    bool Contains(const glm::ivec3& position) const { return m_entries.count(position) > 0; }
+
+    // Moves the encoded data out and removes the entry
+    bool Take(const glm::ivec3& position, std::vector<uint8_t>& data);
+
+    // Drops the least recently stored entry; false when the cache is empty
+    bool EvictOldest(glm::ivec3& position);
+
+    // Drops every entry whose position fails keep(position)
+    template<typename Predicate>
+    void RemoveUnless(Predicate&& keep);
+
+    size_t GetMemoryUsage() const { return m_bytes; }
+    size_t GetCount() const { return m_entries.size(); }
+
+private:
+    // Rough per-entry bookkeeping cost (hash node + order node)
+    static constexpr size_t ENTRY_OVERHEAD = 96;
+
+    struct Entry {
+        std::vector<uint8_t> data;
+        size_t bytes = 0; // Accounted size, data may be moved out before erasing
+        uint64_t stamp = 0;
+    };
+
+    void Erase(std::unordered_map<glm::ivec3, Entry, ivec3Hash>::iterator it);
+
+    std::unordered_map<glm::ivec3, Entry, ivec3Hash> m_entries;
+    std::map<uint64_t, glm::ivec3> m_order; // Store stamp -> position, oldest first
+    uint64_t m_nextStamp = 0;
+    size_t m_bytes = 0;
+};
+
+template<typename Predicate>
+void CompressedChunkCache::RemoveUnless(Predicate&& keep) {
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        auto current = it++;
+        if (!keep(current->first)) {
+            Erase(current);
+        }
+    }
+}
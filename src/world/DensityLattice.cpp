@@ -0,0 +1,26 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "DensityLattice.h"
+
+float DensityLattice::Get(int x, int y, int z) const {
+    constexpr float INV_CELL = 1.0f / CELL;
+
+    const int px = x / CELL;
+    const int py = y / CELL - m_firstCellY;
+    const int pz = z / CELL;
+    const float fx = (x % CELL) * INV_CELL;
+    const float fy = (y % CELL) * INV_CELL;
+    const float fz = (z % CELL) * INV_CELL;
+
+    // Trilinear: along x, then z, then y
+    float c00 = At(px, py, pz) + (At(px + 1, py, pz) - At(px, py, pz)) * fx;
+    float c01 = At(px, py, pz + 1) + (At(px + 1, py, pz + 1) - At(px, py, pz + 1)) * fx;
+    float c10 = At(px, py + 1, pz) + (At(px + 1, py + 1, pz) - At(px, py + 1, pz)) * fx;
+    float c11 = At(px, py + 1, pz + 1) + (At(px + 1, py + 1, pz + 1) - At(px, py + 1, pz + 1)) * fx;
+
+    float c0 = c00 + (c01 - c00) * fz;
+    float c1 = c10 + (c11 - c10) * fz;
+    return c0 + (c1 - c0) * fy;
+}
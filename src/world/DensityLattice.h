@@ -0,0 +1,63 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "Chunk.h"
+#include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+
+// A 3D density field of one chunk sampled on a coarse lattice (every CELL
+// blocks) and trilinearly interpolated inside each cell - up to 64x fewer
+// noise samples than evaluating every voxel. Lattice points sit on world
+// coordinates that are multiples of CELL, so a chunk's face points are exactly
+// the ones its neighbour samples and the field is continuous across chunks.
+// Not tied to caves: any density (overhangs, 3D terrain) can be built the same way.
+class DensityLattice {
+public:
+    static constexpr int CELL = 4;
+    static constexpr int POINTS_XZ = Chunk::SIZE / CELL + 1;
+    static constexpr int MAX_POINTS_Y = Chunk::HEIGHT / CELL + 1;
+    static constexpr size_t MAX_POINTS = POINTS_XZ * POINTS_XZ * MAX_POINTS_Y;
+
+    static_assert(Chunk::SIZE % CELL == 0 && Chunk::HEIGHT % CELL == 0, "Lattice cells must tile a chunk");
+
+    // Samples the lattice cells covering local rows [minY, maxY] of the chunk.
+    // sample(xs, ys, zs, count, out) writes the density at each world position.
+    template<typename Sampler>
+    void Build(const glm::ivec3& chunkPosition, int minY, int maxY, const Sampler& sample);
+
+    // Interpolated density at a local block position within the built rows
+    float Get(int x, int y, int z) const;
+
+    size_t GetSampleCount() const { return static_cast<size_t>(m_pointsY) * POINTS_XZ * POINTS_XZ; }
+
+private:
+    float At(int px, int py, int pz) const { return m_values[(py * POINTS_XZ + pz) * POINTS_XZ + px]; }
+
+    std::array<float, MAX_POINTS> m_values{};
+    int m_firstCellY = 0;
+    int m_pointsY = 0;
+};
+
+template<typename Sampler>
+void DensityLattice::Build(const glm::ivec3& chunkPosition, int minY, int maxY, const Sampler& sample) {
+    m_firstCellY = minY / CELL;
+    m_pointsY = maxY / CELL - m_firstCellY + 2;
+
+    std::array<float, MAX_POINTS> xs, ys, zs;
+    size_t i = 0;
+    for (int py = 0; py < m_pointsY; ++py) {
+        for (int pz = 0; pz < POINTS_XZ; ++pz) {
+            for (int px = 0; px < POINTS_XZ; ++px, ++i) {
+                xs[i] = static_cast<float>(chunkPosition.x * Chunk::SIZE + px * CELL);
+                ys[i] = static_cast<float>(chunkPosition.y * Chunk::HEIGHT + (m_firstCellY + py) * CELL);
+                zs[i] = static_cast<float>(chunkPosition.z * Chunk::SIZE + pz * CELL);
+            }
+        }
+    }
+
+    sample(xs.data(), ys.data(), zs.data(), i, m_values.data());
+}
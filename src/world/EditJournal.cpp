@@ -0,0 +1,359 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "EditJournal.h"
+#include "ChunkCodec.h"
+#include "RegionFile.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace {
+    constexpr size_t FILE_HEADER_SIZE = 8;
+    constexpr size_t COMMIT_HEADER_SIZE = 8;     // magic, body length
+    constexpr size_t CHUNK_HEADER_SIZE = 14;     // x, y, z, edit count
+    constexpr size_t EDIT_SIZE = 3;              // block index, type
+    constexpr size_t COMMIT_TRAILER_SIZE = 4;    // CRC32 of the body
+
+    void WriteU16(std::vector<uint8_t>& out, uint16_t value) {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+    void WriteU32(std::vector<uint8_t>& out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+        }
+    }
+
+    uint16_t ReadU16(const uint8_t* data) {
+        return static_cast<uint16_t>(data[0] | (data[1] << 8));
+    }
+
+    uint32_t ReadU32(const uint8_t* data) {
+        return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+               (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+}
+
+std::string EditJournal::GetPath(const glm::ivec2& regionPosition) const {
+    return (std::filesystem::path(m_directory) / RegionFile::GetFileName(regionPosition, "vxj")).string();
+}
+
+bool EditJournal::Open(const std::string& directory) {
+    m_directory = directory;
+
+    std::error_code error;
+    size_t regionCount = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        glm::ivec2 regionPosition;
+        if (entry.is_regular_file() &&
+            RegionFile::ParseFileName(entry.path().filename().string(), regionPosition, "vxj") &&
+            LoadRegion(regionPosition)) {
+            regionCount++;
+        }
+    }
+
+    if (error) {
+        std::cerr << "Failed to read edit journals in " << directory << ": " << error.message() << std::endl;
+        return false;
+    }
+
+    if (regionCount > 0) {
+        std::cout << "Edit journal: " << GetEditCount() << " edits in " << regionCount << " regions" << std::endl;
+    }
+    return true;
+}
+
+bool EditJournal::LoadRegion(const glm::ivec2& regionPosition) {
+    const std::string path = GetPath(regionPosition);
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < FILE_HEADER_SIZE || ReadU32(data.data()) != FILE_MAGIC ||
+        ReadU32(data.data() + 4) != FILE_VERSION) {
+        std::cerr << "Unsupported edit journal: " << path << std::endl;
+        return false;
+    }
+
+    RegionJournal& journal = m_regions[regionPosition];
+
+    // Replay commits in order; the newest edit of a block wins
+    size_t offset = FILE_HEADER_SIZE;
+    while (offset + COMMIT_HEADER_SIZE + COMMIT_TRAILER_SIZE <= data.size()) {
+        const uint8_t* commit = data.data() + offset;
+        if (ReadU32(commit) != COMMIT_MAGIC) {
+            break;
+        }
+
+        const size_t bodySize = ReadU32(commit + 4);
+        if (offset + COMMIT_HEADER_SIZE + bodySize + COMMIT_TRAILER_SIZE > data.size()) {
+            break; // Torn commit
+        }
+
+        const uint8_t* body = commit + COMMIT_HEADER_SIZE;
+        if (ChunkCodec::Crc32(body, bodySize) != ReadU32(body + bodySize)) {
+            break;
+        }
+
+        size_t position = 0;
+        while (position + CHUNK_HEADER_SIZE <= bodySize) {
+            glm::ivec3 chunkPosition(static_cast<int32_t>(ReadU32(body + position)),
+                                     static_cast<int32_t>(ReadU32(body + position + 4)),
+                                     static_cast<int32_t>(ReadU32(body + position + 8)));
+            const size_t count = ReadU16(body + position + 12);
+            position += CHUNK_HEADER_SIZE;
+
+            ChunkEdits& edits = journal.chunks[chunkPosition];
+            for (size_t i = 0; i < count && position + EDIT_SIZE <= bodySize; ++i, position += EDIT_SIZE) {
+                uint16_t blockIndex = ReadU16(body + position);
+                if (blockIndex < Chunk::TOTAL_BLOCKS) {
+                    edits[blockIndex] = static_cast<BlockType>(body[position + 2]);
+                }
+            }
+        }
+
+        offset += COMMIT_HEADER_SIZE + bodySize + COMMIT_TRAILER_SIZE;
+    }
+
+    // Cut off a torn tail so later appends stay reachable
+    if (offset < data.size()) {
+        std::cerr << "Discarding " << data.size() - offset << " torn bytes in " << path << std::endl;
+        file.close();
+        std::error_code error;
+        std::filesystem::resize_file(path, offset, error);
+    }
+
+    journal.fileBytes = offset;
+    journal.entryCount = 0;
+    for (const auto& [chunkPosition, edits] : journal.chunks) {
+        journal.entryCount += edits.size();
+    }
+    return true;
+}
+
+void EditJournal::RecordEdit(const glm::ivec3& chunkPosition, int x, int y, int z, BlockType type) {
+    const uint16_t blockIndex = PackBlockIndex(x, y, z);
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    RegionJournal& journal = m_regions[RegionFile::GetRegionPosition(chunkPosition)];
+
+    ChunkEdits& edits = journal.chunks[chunkPosition];
+    if (edits.insert_or_assign(blockIndex, type).second) {
+        journal.entryCount++;
+    }
+    journal.pending.push_back({chunkPosition, blockIndex, type});
+}
+
+size_t EditJournal::ApplyEdits(Chunk& chunk) const {
+    const glm::ivec3& chunkPosition = chunk.GetPosition();
+
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto regionIt = m_regions.find(RegionFile::GetRegionPosition(chunkPosition));
+    if (regionIt == m_regions.end()) {
+        return 0;
+    }
+
+    auto chunkIt = regionIt->second.chunks.find(chunkPosition);
+    if (chunkIt == regionIt->second.chunks.end()) {
+        return 0;
+    }
+
+    for (const auto& [blockIndex, type] : chunkIt->second) {
+        int x = blockIndex % Chunk::SIZE;
+        int z = (blockIndex / Chunk::SIZE) % Chunk::SIZE;
+        int y = blockIndex / (Chunk::SIZE * Chunk::SIZE);
+        chunk.SetBlock(x, y, z, type);
+    }
+    return chunkIt->second.size();
+}
+
+bool EditJournal::HasEdits(const glm::ivec3& chunkPosition) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto regionIt = m_regions.find(RegionFile::GetRegionPosition(chunkPosition));
+    return regionIt != m_regions.end() && regionIt->second.chunks.count(chunkPosition) > 0;
+}
+
+void EditJournal::SerializeCommit(const std::vector<Edit>& edits, std::vector<uint8_t>& out) {
+    // Group by chunk (in recording order within a chunk) to share the position header
+    std::map<std::tuple<int, int, int>, std::vector<const Edit*>> byChunk;
+    for (const Edit& edit : edits) {
+        byChunk[{edit.chunkPosition.x, edit.chunkPosition.y, edit.chunkPosition.z}].push_back(&edit);
+    }
+
+    std::vector<uint8_t> body;
+    for (const auto& [key, chunkEdits] : byChunk) {
+        // The count field is 16 bits wide - split oversized groups
+        for (size_t start = 0; start < chunkEdits.size(); start += UINT16_MAX) {
+            size_t count = std::min<size_t>(UINT16_MAX, chunkEdits.size() - start);
+            WriteU32(body, static_cast<uint32_t>(std::get<0>(key)));
+            WriteU32(body, static_cast<uint32_t>(std::get<1>(key)));
+            WriteU32(body, static_cast<uint32_t>(std::get<2>(key)));
+            WriteU16(body, static_cast<uint16_t>(count));
+
+            for (size_t i = start; i < start + count; ++i) {
+                WriteU16(body, chunkEdits[i]->blockIndex);
+                body.push_back(static_cast<uint8_t>(chunkEdits[i]->type));
+            }
+        }
+    }
+
+    WriteU32(out, COMMIT_MAGIC);
+    WriteU32(out, static_cast<uint32_t>(body.size()));
+    out.insert(out.end(), body.begin(), body.end());
+    WriteU32(out, ChunkCodec::Crc32(body.data(), body.size()));
+}
+
+size_t EditJournal::Commit() {
+    // Take every region's pending edits in one go
+    std::vector<std::pair<glm::ivec2, std::vector<Edit>>> commits;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        for (auto& [regionPosition, journal] : m_regions) {
+            if (!journal.pending.empty()) {
+                commits.emplace_back(regionPosition, std::move(journal.pending));
+                journal.pending.clear();
+            }
+        }
+    }
+
+    size_t committed = 0;
+    std::vector<uint8_t> data;
+    for (const auto& [regionPosition, edits] : commits) {
+        const std::string path = GetPath(regionPosition);
+        const bool isNew = !std::filesystem::exists(path);
+
+        data.clear();
+        if (isNew) {
+            WriteU32(data, FILE_MAGIC);
+            WriteU32(data, FILE_VERSION);
+        }
+        SerializeCommit(edits, data);
+
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        file.flush();
+        if (!file) {
+            std::cerr << "Failed to append to edit journal: " << path << std::endl;
+            file.close();
+
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+            RegionJournal& journal = m_regions[regionPosition];
+
+            // Drop whatever part of the commit reached the file. Left in place,
+            // the next load would stop at it and cut off every later commit;
+            // a torn header would make the whole file unreadable.
+            std::error_code error;
+            if (isNew) {
+                std::filesystem::remove(path, error);
+            } else {
+                std::filesystem::resize_file(path, journal.fileBytes, error);
+            }
+            if (error) {
+                std::cerr << "Failed to roll back edit journal " << path << ": " << error.message() << std::endl;
+            }
+
+            // Keep the edits queued for the next commit
+            journal.pending.insert(journal.pending.begin(), edits.begin(), edits.end());
+            continue;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_regions[regionPosition].fileBytes += data.size();
+        committed += edits.size();
+    }
+
+    return committed;
+}
+
+uint64_t EditJournal::GetCompactSize(const RegionJournal& journal) const {
+    return FILE_HEADER_SIZE + COMMIT_HEADER_SIZE + COMMIT_TRAILER_SIZE +
+           journal.chunks.size() * CHUNK_HEADER_SIZE + journal.entryCount * EDIT_SIZE;
+}
+
+void EditJournal::Compact() {
+    // Snapshot the regions worth compacting. Edits recorded meanwhile are
+    // still pending and get appended to the new file by the next Commit().
+    std::vector<std::pair<glm::ivec2, std::vector<Edit>>> rewrites;
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        for (const auto& [regionPosition, journal] : m_regions) {
+            uint64_t compactSize = GetCompactSize(journal);
+            if (journal.fileBytes < MIN_COMPACTION_BYTES || journal.fileBytes < compactSize * 2) {
+                continue;
+            }
+
+            std::vector<Edit> edits;
+            edits.reserve(journal.entryCount);
+            for (const auto& [chunkPosition, chunkEdits] : journal.chunks) {
+                for (const auto& [blockIndex, type] : chunkEdits) {
+                    edits.push_back({chunkPosition, blockIndex, type});
+                }
+            }
+            rewrites.emplace_back(regionPosition, std::move(edits));
+        }
+    }
+
+    std::vector<uint8_t> data;
+    for (const auto& [regionPosition, edits] : rewrites) {
+        const std::string path = GetPath(regionPosition);
+        const std::string tempPath = path + ".tmp";
+
+        data.clear();
+        WriteU32(data, FILE_MAGIC);
+        WriteU32(data, FILE_VERSION);
+        SerializeCommit(edits, data);
+
+        bool written;
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(data.data()), data.size());
+            file.flush();
+            written = static_cast<bool>(file);
+        }
+
+        std::error_code error;
+        if (!written) {
+            // Don't leave a partial image behind; the old journal stays valid
+            std::cerr << "Failed to write compacted edit journal " << tempPath << std::endl;
+            std::filesystem::remove(tempPath, error);
+            continue;
+        }
+
+        std::filesystem::rename(tempPath, path, error);
+        if (error) {
+            std::cerr << "Failed to compact edit journal " << path << ": " << error.message() << std::endl;
+            std::filesystem::remove(tempPath, error);
+            continue;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        RegionJournal& journal = m_regions[regionPosition];
+        std::cout << "Compacted edit journal " << RegionFile::GetFileName(regionPosition, "vxj") << ": "
+                  << journal.fileBytes / 1024 << " KB -> " << data.size() / 1024 << " KB" << std::endl;
+        journal.fileBytes = data.size();
+    }
+}
+
+size_t EditJournal::GetEditCount() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    size_t count = 0;
+    for (const auto& [regionPosition, journal] : m_regions) {
+        count += journal.entryCount;
+    }
+    return count;
+}
+
+size_t EditJournal::GetPendingCount() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    size_t count = 0;
+    for (const auto& [regionPosition, journal] : m_regions) {
+        count += journal.pending.size();
+    }
+    return count;
+}
@@ -0,0 +1,82 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "Chunk.h"
+#include "../utils/Math.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Block edits on top of the deterministic generator output.
+// Every SetBlock is recorded as (chunk, block, new type); a chunk is restored
+// by regenerating it and replaying its edits. On disk each region has an
+// append-only journal ("r.<x>.<z>.vxj") made of group commits, each with its
+// own CRC, so a torn commit is dropped as a whole. Superseded entries are
+// removed by compaction.
+class EditJournal {
+public:
+    static constexpr uint64_t MIN_COMPACTION_BYTES = 64 * 1024;
+
+    EditJournal() = default;
+
+    EditJournal(const EditJournal&) = delete;
+    EditJournal& operator=(const EditJournal&) = delete;
+
+    // Reads every journal in the directory into memory
+    bool Open(const std::string& directory);
+
+    // Any thread. Visible to ApplyEdits immediately, written by the next Commit().
+    void RecordEdit(const glm::ivec3& chunkPosition, int x, int y, int z, BlockType type);
+
+    // Any thread. Replays the chunk's edits, returns how many were applied.
+    size_t ApplyEdits(Chunk& chunk) const;
+    bool HasEdits(const glm::ivec3& chunkPosition) const;
+
+    // Storage I/O thread only
+    size_t Commit();  // Appends one commit per region with pending edits
+    void Compact();   // Rewrites journals dominated by superseded entries
+
+    // Statistics
+    size_t GetEditCount() const;
+    size_t GetPendingCount() const;
+
+private:
+    static constexpr uint32_t FILE_MAGIC = 0x4A525856;   // "VXRJ"
+    static constexpr uint32_t FILE_VERSION = 1;
+    static constexpr uint32_t COMMIT_MAGIC = 0x434A5856; // "VXJC"
+
+    struct Edit {
+        glm::ivec3 chunkPosition;
+        uint16_t blockIndex;
+        BlockType type;
+    };
+
+    using ChunkEdits = std::unordered_map<uint16_t, BlockType>;
+
+    struct RegionJournal {
+        std::unordered_map<glm::ivec3, ChunkEdits, ivec3Hash> chunks;
+        std::vector<Edit> pending; // Recorded but not yet committed
+        size_t entryCount = 0;     // Live edits across all chunks
+        uint64_t fileBytes = 0;
+    };
+
+    static uint16_t PackBlockIndex(int x, int y, int z) {
+        return static_cast<uint16_t>((y * Chunk::SIZE + z) * Chunk::SIZE + x);
+    }
+
+    std::string GetPath(const glm::ivec2& regionPosition) const;
+    bool LoadRegion(const glm::ivec2& regionPosition);
+    static void SerializeCommit(const std::vector<Edit>& edits, std::vector<uint8_t>& out);
+    uint64_t GetCompactSize(const RegionJournal& journal) const;
+
+    std::string m_directory;
+
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<glm::ivec2, RegionJournal, ivec2Hash> m_regions;
+};
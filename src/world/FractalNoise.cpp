@@ -0,0 +1,70 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "FractalNoise.h"
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VOXEL_NOISE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VOXEL_NOISE_SSE2
+#endif
+
+// Operation order matches FastNoiseLite's fractal loops exactly:
+//   FBm:    sum += noise * amp
+//   Ridged: sum += (|noise| * -2 + 1) * amp
+
+void NoiseKernels::AccumulateFBm(float* sum, const float* noise, float amplitude, size_t count) {
+    size_t i = 0;
+
+#if defined(VOXEL_NOISE_AVX2)
+    const __m256 amp = _mm256_set1_ps(amplitude);
+    for (; i + 8 <= count; i += 8) {
+        __m256 value = _mm256_mul_ps(_mm256_loadu_ps(noise + i), amp);
+        _mm256_storeu_ps(sum + i, _mm256_add_ps(_mm256_loadu_ps(sum + i), value));
+    }
+#elif defined(VOXEL_NOISE_SSE2)
+    const __m128 amp = _mm_set1_ps(amplitude);
+    for (; i + 4 <= count; i += 4) {
+        __m128 value = _mm_mul_ps(_mm_loadu_ps(noise + i), amp);
+        _mm_storeu_ps(sum + i, _mm_add_ps(_mm_loadu_ps(sum + i), value));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        sum[i] += noise[i] * amplitude;
+    }
+}
+
+void NoiseKernels::AccumulateRidged(float* sum, const float* noise, float amplitude, size_t count) {
+    size_t i = 0;
+
+#if defined(VOXEL_NOISE_AVX2)
+    const __m256 amp = _mm256_set1_ps(amplitude);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 minusTwo = _mm256_set1_ps(-2.0f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m256 ridge = _mm256_andnot_ps(signMask, _mm256_loadu_ps(noise + i));
+        ridge = _mm256_add_ps(_mm256_mul_ps(ridge, minusTwo), one);
+        _mm256_storeu_ps(sum + i, _mm256_add_ps(_mm256_loadu_ps(sum + i), _mm256_mul_ps(ridge, amp)));
+    }
+#elif defined(VOXEL_NOISE_SSE2)
+    const __m128 amp = _mm_set1_ps(amplitude);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 minusTwo = _mm_set1_ps(-2.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 ridge = _mm_andnot_ps(signMask, _mm_loadu_ps(noise + i));
+        ridge = _mm_add_ps(_mm_mul_ps(ridge, minusTwo), one);
+        _mm_storeu_ps(sum + i, _mm_add_ps(_mm_loadu_ps(sum + i), _mm_mul_ps(ridge, amp)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        sum[i] += (std::abs(noise[i]) * -2.0f + 1.0f) * amplitude;
+    }
+}
@@ -0,0 +1,110 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "FastNoiseLite.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+// Lane kernels for octave accumulation: AVX2 or SSE2 when the target has
+// them, scalar otherwise. sum[i] += f(noise[i]) * amplitude.
+namespace NoiseKernels {
+    void AccumulateFBm(float* sum, const float* noise, float amplitude, size_t count);
+    void AccumulateRidged(float* sum, const float* noise, float amplitude, size_t count);
+}
+
+// A FastNoiseLite fractal (FBm or Ridged) split into one single-octave
+// generator per octave, so whole grids are evaluated octave by octave
+// instead of point by point. Octave i uses seed + i and frequency *
+// lacunarity^i and is weighted like FastNoiseLite does; with a power of two
+// lacunarity the per-octave inputs are bit-identical to GetNoise(), sums
+// agree up to FMA contraction. Thread-safe after construction.
+template<int Octaves>
+class FractalNoise {
+public:
+    static_assert(Octaves > 0, "FractalNoise needs at least one octave");
+
+    FractalNoise(FastNoiseLite::NoiseType type, int seed, float frequency,
+                 FastNoiseLite::FractalType fractal = FastNoiseLite::FractalType_FBm,
+                 float lacunarity = 2.0f, float gain = 0.5f)
+        : m_ridged(fractal == FastNoiseLite::FractalType_Ridged) {
+
+        // Same bounding FastNoiseLite derives from gain and octave count
+        float amplitude = std::abs(gain);
+        float amplitudeSum = 1.0f;
+        for (int i = 1; i < Octaves; ++i) {
+            amplitudeSum += amplitude;
+            amplitude *= gain;
+        }
+
+        float octaveAmplitude = 1.0f / amplitudeSum;
+        float octaveFrequency = frequency;
+        for (int i = 0; i < Octaves; ++i) {
+            m_octaves[i].SetNoiseType(type);
+            m_octaves[i].SetSeed(seed + i);
+            m_octaves[i].SetFrequency(octaveFrequency);
+            m_octaves[i].SetFractalType(FastNoiseLite::FractalType_None);
+            m_amplitudes[i] = octaveAmplitude;
+
+            octaveFrequency *= lacunarity;
+            octaveAmplitude *= gain;
+        }
+    }
+
+    // out[i] = noise at (xs[i], ys[i])
+    void Fill2D(const float* xs, const float* ys, size_t count, float* out) const {
+        Fill(count, out, [xs, ys](const FastNoiseLite& octave, size_t i) {
+            return octave.GetNoise(xs[i], ys[i]);
+        });
+    }
+
+    // out[i] = noise at (xs[i], ys[i], zs[i])
+    void Fill3D(const float* xs, const float* ys, const float* zs, size_t count, float* out) const {
+        Fill(count, out, [xs, ys, zs](const FastNoiseLite& octave, size_t i) {
+            return octave.GetNoise(xs[i], ys[i], zs[i]);
+        });
+    }
+
+private:
+    // Lanes per block: the octave results stay in L1 between accumulations
+    static constexpr size_t BATCH = 256;
+
+    template<typename Sampler>
+    void Fill(size_t count, float* out, const Sampler& sample) const {
+        float noise[BATCH];
+
+        for (size_t start = 0; start < count; start += BATCH) {
+            const size_t lanes = std::min(BATCH, count - start);
+            float* sum = out + start;
+            std::fill_n(sum, lanes, 0.0f);
+
+            ForEachOctave([&](auto octave) {
+                const FastNoiseLite& generator = m_octaves[octave];
+                for (size_t i = 0; i < lanes; ++i) {
+                    noise[i] = sample(generator, start + i);
+                }
+
+                if (m_ridged) {
+                    NoiseKernels::AccumulateRidged(sum, noise, m_amplitudes[octave], lanes);
+                } else {
+                    NoiseKernels::AccumulateFBm(sum, noise, m_amplitudes[octave], lanes);
+                }
+            }, std::make_index_sequence<Octaves>());
+        }
+    }
+
+    // Unrolls the octave loop at compile time
+    template<typename Function, size_t... Index>
+    static void ForEachOctave(Function&& function, std::index_sequence<Index...>) {
+        (function(std::integral_constant<size_t, Index>()), ...);
+    }
+
+    std::array<FastNoiseLite, Octaves> m_octaves;
+    std::array<float, Octaves> m_amplitudes{};
+    bool m_ridged = false;
+};
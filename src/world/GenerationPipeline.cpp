@@ -0,0 +1,132 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "GenerationPipeline.h"
+#include <chrono>
+
+namespace {
+    uint64_t NanosecondsSince(std::chrono::steady_clock::time_point start) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+GenerationPipeline::GenerationPipeline(const WorldGenerator& generator, GenerationPool& pool)
+    : m_generator(generator), m_pool(pool) {
+}
+
+// Jobs still parked here (the pool dropped their column tasks on Stop) free their chunks
+GenerationPipeline::~GenerationPipeline() = default;
+
+void GenerationPipeline::Submit(std::unique_ptr<Chunk> chunk, Callback done) {
+    auto job = std::make_shared<Job>();
+    job->chunk = std::move(chunk);
+    job->done = std::move(done);
+    Advance(job);
+}
+
+void GenerationPipeline::Advance(const std::shared_ptr<Job>& job) {
+    while (job->nextStage < WorldGenerator::STAGE_COUNT) {
+        auto stage = static_cast<WorldGenerator::Stage>(job->nextStage);
+
+        int radius = WorldGenerator::GetStageInfo(stage).columnRadius;
+        if (radius > job->columnRadius) {
+            job->columnRadius = radius;
+            if (ParkUntilColumns(job, radius)) {
+                return;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        m_generator.RunStage(stage, job->chunk.get());
+        m_stageTime[job->nextStage].fetch_add(NanosecondsSince(start), std::memory_order_relaxed);
+        job->nextStage++;
+    }
+
+    m_completedCount.fetch_add(1, std::memory_order_relaxed);
+    job->done(std::move(job->chunk));
+}
+
+bool GenerationPipeline::ParkUntilColumns(const std::shared_ptr<Job>& job, int radius) {
+    const glm::ivec3& position = job->chunk->GetPosition();
+    std::vector<glm::ivec2> toSample;
+
+    // Held by us until every missing column is registered, so an early
+    // arrival can't resume the job while we're still parking it
+    job->missingColumns.store(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int dz = -radius; dz <= radius; ++dz) {
+            for (int dx = -radius; dx <= radius; ++dx) {
+                glm::ivec2 column(position.x + dx, position.z + dz);
+
+                // In flight: wait for it. Checked before the cache because
+                // the sampling task inserts first and unregisters after.
+                auto it = m_sampling.find(column);
+                if (it != m_sampling.end()) {
+                    it->second.push_back(job);
+                    job->missingColumns.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (m_generator.HasColumn(column.x, column.y)) {
+                    continue;
+                }
+
+                m_sampling[column].push_back(job);
+                job->missingColumns.fetch_add(1, std::memory_order_relaxed);
+                toSample.push_back(column);
+            }
+        }
+    }
+
+    for (const glm::ivec2& column : toSample) {
+        m_pool.Submit([this, column] { SampleColumnTask(column); });
+    }
+
+    if (job->missingColumns.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        return false; // Everything arrived meanwhile, or was cached already
+    }
+
+    m_parkCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void GenerationPipeline::SampleColumnTask(const glm::ivec2& column) {
+    auto start = std::chrono::steady_clock::now();
+    m_generator.GetColumn(column.x, column.y); // Samples into the column cache
+    m_columnTime.fetch_add(NanosecondsSince(start), std::memory_order_relaxed);
+    m_columnCount.fetch_add(1, std::memory_order_relaxed);
+
+    std::vector<std::shared_ptr<Job>> waiting;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_sampling.find(column);
+        if (it != m_sampling.end()) {
+            waiting = std::move(it->second);
+            m_sampling.erase(it);
+        }
+    }
+
+    for (std::shared_ptr<Job>& job : waiting) {
+        if (job->missingColumns.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            // Lands on this worker's own deque, behind the work already queued there
+            m_pool.Submit([this, job] { Advance(job); });
+        }
+    }
+}
+
+uint64_t GenerationPipeline::GetStageNanoseconds(WorldGenerator::Stage stage) const {
+    return m_stageTime[static_cast<size_t>(stage)].load(std::memory_order_relaxed);
+}
+
+void GenerationPipeline::ResetStats() {
+    for (auto& time : m_stageTime) {
+        time.store(0, std::memory_order_relaxed);
+    }
+    m_columnTime.store(0, std::memory_order_relaxed);
+    m_columnCount.store(0, std::memory_order_relaxed);
+    m_completedCount.store(0, std::memory_order_relaxed);
+    m_parkCount.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,75 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "WorldGenerator.h"
+#include "GenerationPool.h"
+#include "../utils/Math.h"
+#include <glm/glm.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Runs the WorldGenerator stages of many chunks on the generation pool.
+// A chunk advances through its stages on one worker for as long as the column
+// samples the next stage declares (StageInfo::columnRadius) are cached. When
+// some are missing they are sampled as tasks of their own and the chunk is
+// parked until the last one lands, so the worker moves on to other chunks
+// instead of sampling a neighbourhood inline.
+class GenerationPipeline {
+public:
+    using Callback = std::function<void(std::unique_ptr<Chunk>)>;
+
+    GenerationPipeline(const WorldGenerator& generator, GenerationPool& pool);
+    ~GenerationPipeline();
+
+    GenerationPipeline(const GenerationPipeline&) = delete;
+    GenerationPipeline& operator=(const GenerationPipeline&) = delete;
+
+    // Thread-safe. done(chunk) runs on a worker once every stage has run.
+    void Submit(std::unique_ptr<Chunk> chunk, Callback done);
+
+    // Statistics. Times are summed over all workers.
+    uint64_t GetStageNanoseconds(WorldGenerator::Stage stage) const;
+    uint64_t GetColumnNanoseconds() const { return m_columnTime.load(std::memory_order_relaxed); }
+    uint64_t GetColumnCount() const { return m_columnCount.load(std::memory_order_relaxed); }
+    uint64_t GetCompletedCount() const { return m_completedCount.load(std::memory_order_relaxed); }
+    uint64_t GetParkCount() const { return m_parkCount.load(std::memory_order_relaxed); }
+    void ResetStats();
+
+private:
+    struct Job {
+        std::unique_ptr<Chunk> chunk;
+        Callback done;
+        size_t nextStage = 0;
+        int columnRadius = -1;          // Columns known to be sampled around the chunk
+        std::atomic<int> missingColumns{0};
+    };
+
+    void Advance(const std::shared_ptr<Job>& job);
+
+    // Requests the columns within radius that aren't cached yet. True when
+    // the job was parked; the last column to arrive resubmits it.
+    bool ParkUntilColumns(const std::shared_ptr<Job>& job, int radius);
+    void SampleColumnTask(const glm::ivec2& column);
+
+    const WorldGenerator& m_generator;
+    GenerationPool& m_pool;
+
+    // Columns being sampled and the jobs parked on each of them
+    std::mutex m_mutex;
+    std::unordered_map<glm::ivec2, std::vector<std::shared_ptr<Job>>, ivec2Hash> m_sampling;
+
+    std::array<std::atomic<uint64_t>, WorldGenerator::STAGE_COUNT> m_stageTime{};
+    std::atomic<uint64_t> m_columnTime{0};
+    std::atomic<uint64_t> m_columnCount{0};
+    std::atomic<uint64_t> m_completedCount{0};
+    std::atomic<uint64_t> m_parkCount{0};
+};
@@ -0,0 +1,146 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "GenerationPool.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // Lets Submit() recognise calls coming from one of our own workers
+    thread_local const GenerationPool* t_currentPool = nullptr;
+    thread_local uint32_t t_workerIndex = 0;
+}
+
+GenerationPool::GenerationPool(uint32_t workerCount) {
+    if (workerCount == 0) {
+        workerCount = GetDefaultWorkerCount();
+    }
+
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+}
+
+GenerationPool::~GenerationPool() {
+    Stop();
+}
+
+uint32_t GenerationPool::GetDefaultWorkerCount() {
+    // Leave one core for the main (render) thread
+    uint32_t cores = std::thread::hardware_concurrency();
+    return std::max(1u, cores > 1 ? cores - 1 : 1u);
+}
+
+void GenerationPool::Start() {
+    m_shouldStop = false;
+    for (uint32_t i = 0; i < m_workers.size(); ++i) {
+        m_workers[i]->thread = std::thread(&GenerationPool::WorkerThreadFunc, this, i);
+    }
+
+    std::cout << "Generation pool started with " << m_workers.size() << " workers" << std::endl;
+}
+
+void GenerationPool::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_shouldStop = true;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    // Drop whatever was still queued
+    for (auto& worker : m_workers) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        m_pendingTasks -= worker->tasks.size();
+        worker->tasks.clear();
+    }
+}
+
+void GenerationPool::Submit(Task task) {
+    uint32_t index;
+    if (t_currentPool == this) {
+        index = t_workerIndex;
+    } else {
+        index = m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+    }
+
+    {
+        // Count first so a worker popping the task can never see the counter underflow.
+        // Taking the sleep mutex orders the increment against a worker that is
+        // about to wait, so the wakeup can't be lost
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_pendingTasks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+        m_workers[index]->tasks.push_back(std::move(task));
+    }
+    m_wakeCondition.notify_one();
+}
+
+bool GenerationPool::PopLocal(uint32_t index, Task& task) {
+    Worker& worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+
+    // Owner takes the oldest task so requests keep their submission (distance) order
+    task = std::move(worker.tasks.front());
+    worker.tasks.pop_front();
+    return true;
+}
+
+bool GenerationPool::Steal(uint32_t thiefIndex, Task& task) {
+    const uint32_t count = static_cast<uint32_t>(m_workers.size());
+
+    for (uint32_t offset = 1; offset < count; ++offset) {
+        Worker& victim = *m_workers[(thiefIndex + offset) % count];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.tasks.empty()) {
+            continue;
+        }
+
+        // Thieves take from the opposite end to keep contention with the owner low
+        task = std::move(victim.tasks.back());
+        victim.tasks.pop_back();
+        return true;
+    }
+
+    return false;
+}
+
+void GenerationPool::WorkerThreadFunc(uint32_t index) {
+    t_currentPool = this;
+    t_workerIndex = index;
+
+    while (true) {
+        Task task;
+
+        if (PopLocal(index, task) || Steal(index, task)) {
+            m_pendingTasks.fetch_sub(1, std::memory_order_relaxed);
+            task();
+            continue;
+        }
+
+        // Nothing to do - block until work arrives instead of polling
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wakeCondition.wait(lock, [this] {
+            return m_shouldStop.load() || m_pendingTasks.load(std::memory_order_relaxed) > 0;
+        });
+
+        if (m_shouldStop) {
+            break;
+        }
+    }
+
+    t_currentPool = nullptr;
+}
@@ -0,0 +1,58 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool of chunk generation workers.
+// Every worker owns a deque of tasks; idle workers steal from the back of other
+// workers' deques and block on a condition variable when the whole pool is empty.
+class GenerationPool {
+public:
+    using Task = std::function<void()>;
+
+    // workerCount == 0 picks a default based on hardware concurrency
+    explicit GenerationPool(uint32_t workerCount = 0);
+    ~GenerationPool();
+
+    void Start();
+    void Stop();
+
+    // Thread-safe. Tasks submitted from a worker go to that worker's own deque.
+    void Submit(Task task);
+
+    size_t GetPendingCount() const { return m_pendingTasks.load(std::memory_order_relaxed); }
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+    static uint32_t GetDefaultWorkerCount();
+
+private:
+    struct Worker {
+        std::deque<Task> tasks;
+        std::mutex mutex;
+        std::thread thread;
+    };
+
+    void WorkerThreadFunc(uint32_t index);
+    bool PopLocal(uint32_t index, Task& task);
+    bool Steal(uint32_t thiefIndex, Task& task);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<uint32_t> m_nextWorker{0};
+    std::atomic<size_t> m_pendingTasks{0};
+
+    // Sleeping workers wait here until new work arrives
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeCondition;
+    std::atomic<bool> m_shouldStop{false};
+};
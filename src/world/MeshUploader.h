@@ -0,0 +1,50 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "Chunk.h"
+#include <cstdint>
+#include <vector>
+
+// GPU side of chunk meshes. The world core only talks to this interface,
+// so it builds and runs without a window or an OpenGL context.
+// All calls happen on the main thread.
+class MeshUploader {
+public:
+    virtual ~MeshUploader() = default;
+
+    // Replaces the mesh behind the handle, creating GPU objects on first use.
+    // Only called with non-empty meshes.
+    virtual void Upload(Chunk::MeshHandle& handle,
+                        const std::vector<Chunk::Vertex>& vertices,
+                        const std::vector<uint32_t>& indices) = 0;
+
+    // Frees whatever Upload created and clears the handle
+    virtual void Release(Chunk::MeshHandle& handle) = 0;
+};
+
+// Discards meshes and only counts them - for headless runs
+class NullMeshUploader : public MeshUploader {
+public:
+    void Upload(Chunk::MeshHandle& handle,
+                const std::vector<Chunk::Vertex>& vertices,
+                const std::vector<uint32_t>& indices) override {
+        handle.vertexCapacity = vertices.size() * sizeof(Chunk::Vertex);
+        handle.indexCapacity = indices.size() * sizeof(uint32_t);
+        m_uploadCount++;
+        m_uploadedBytes += handle.vertexCapacity + handle.indexCapacity;
+    }
+
+    void Release(Chunk::MeshHandle& handle) override {
+        handle = Chunk::MeshHandle();
+    }
+
+    uint64_t GetUploadCount() const { return m_uploadCount; }
+    uint64_t GetUploadedBytes() const { return m_uploadedBytes; }
+
+private:
+    uint64_t m_uploadCount = 0;
+    uint64_t m_uploadedBytes = 0;
+};
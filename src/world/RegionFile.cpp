@@ -0,0 +1,279 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "RegionFile.h"
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+    // Largest payload we accept when scanning; protects against garbage lengths
+    constexpr uint32_t MAX_RECORD_LENGTH = 1u << 20;
+
+    void PutU32(uint8_t* out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            out[i] = static_cast<uint8_t>(value >> (i * 8));
+        }
+    }
+
+    uint32_t GetU32(const uint8_t* data) {
+        return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+               (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+}
+
+RegionFile::RegionFile(const std::string& path)
+    : m_path(path) {
+}
+
+RegionFile::~RegionFile() {
+    if (m_file.is_open()) {
+        m_file.flush();
+    }
+}
+
+std::string RegionFile::GetFileName(const glm::ivec2& regionPosition, const char* extension) {
+    return "r." + std::to_string(regionPosition.x) + "." + std::to_string(regionPosition.y) + "." + extension;
+}
+
+bool RegionFile::ParseFileName(const std::string& fileName, glm::ivec2& regionPosition, const char* extension) {
+    int x = 0;
+    int z = 0;
+    if (std::sscanf(fileName.c_str(), "r.%d.%d.", &x, &z) != 2 ||
+        GetFileName(glm::ivec2(x, z), extension) != fileName) {
+        return false;
+    }
+
+    regionPosition = glm::ivec2(x, z);
+    return true;
+}
+
+bool RegionFile::WriteHeader(std::fstream& file) {
+    uint8_t header[FILE_HEADER_SIZE];
+    PutU32(header, FILE_MAGIC);
+    PutU32(header + 4, FILE_VERSION);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    return static_cast<bool>(file);
+}
+
+bool RegionFile::Open() {
+    if (!std::filesystem::exists(m_path)) {
+        std::ofstream create(m_path, std::ios::binary);
+        if (!create) {
+            std::cerr << "Failed to create region file: " << m_path << std::endl;
+            return false;
+        }
+    }
+
+    m_file.open(m_path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!m_file) {
+        std::cerr << "Failed to open region file: " << m_path << std::endl;
+        return false;
+    }
+
+    return ScanRecords();
+}
+
+bool RegionFile::ScanRecords() {
+    m_index.clear();
+    m_liveBytes = 0;
+    m_deadBytes = 0;
+
+    m_file.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(m_file.tellg());
+    m_file.seekg(0);
+
+    if (fileSize < FILE_HEADER_SIZE) {
+        // New (or torn) file - start over with a fresh header
+        m_file.clear();
+        m_file.seekp(0);
+        m_endOffset = FILE_HEADER_SIZE;
+        return WriteHeader(m_file) && static_cast<bool>(m_file.flush());
+    }
+
+    uint8_t header[FILE_HEADER_SIZE];
+    m_file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!m_file || GetU32(header) != FILE_MAGIC || GetU32(header + 4) != FILE_VERSION) {
+        std::cerr << "Unsupported region file: " << m_path << std::endl;
+        return false;
+    }
+
+    uint64_t offset = FILE_HEADER_SIZE;
+    while (offset + RECORD_HEADER_SIZE <= fileSize) {
+        uint8_t record[RECORD_HEADER_SIZE];
+        m_file.seekg(static_cast<std::streamoff>(offset));
+        m_file.read(reinterpret_cast<char*>(record), sizeof(record));
+        if (!m_file || GetU32(record) != RECORD_MAGIC) {
+            break;
+        }
+
+        glm::ivec3 position(static_cast<int32_t>(GetU32(record + 4)),
+                            static_cast<int32_t>(GetU32(record + 8)),
+                            static_cast<int32_t>(GetU32(record + 12)));
+        uint32_t length = GetU32(record + 16);
+        if (length > MAX_RECORD_LENGTH || offset + RECORD_HEADER_SIZE + length > fileSize) {
+            break; // Torn write
+        }
+
+        auto it = m_index.find(position);
+        if (it != m_index.end()) {
+            m_deadBytes += RECORD_HEADER_SIZE + it->second.length;
+            m_liveBytes -= RECORD_HEADER_SIZE + it->second.length;
+        }
+        m_index[position] = {offset + RECORD_HEADER_SIZE, length};
+        m_liveBytes += RECORD_HEADER_SIZE + length;
+
+        offset += RECORD_HEADER_SIZE + length;
+    }
+
+    // Anything past the last valid record gets overwritten by the next append
+    m_deadBytes += fileSize - offset;
+    m_endOffset = offset;
+    m_file.clear();
+    return true;
+}
+
+bool RegionFile::Read(const glm::ivec3& chunkPosition, std::vector<uint8_t>& payload) {
+    auto it = m_index.find(chunkPosition);
+    if (it == m_index.end()) {
+        return false;
+    }
+
+    payload.resize(it->second.length);
+    m_file.seekg(static_cast<std::streamoff>(it->second.offset));
+    m_file.read(reinterpret_cast<char*>(payload.data()), payload.size());
+    if (!m_file) {
+        m_file.clear();
+        return false;
+    }
+    return true;
+}
+
+bool RegionFile::Write(const std::vector<std::pair<glm::ivec3, std::vector<uint8_t>>>& records) {
+    m_file.seekp(static_cast<std::streamoff>(m_endOffset));
+
+    // Where each record lands; the index only takes them once they're on disk
+    std::vector<RecordLocation> locations;
+    locations.reserve(records.size());
+    uint64_t offset = m_endOffset;
+
+    for (const auto& [position, payload] : records) {
+        uint8_t header[RECORD_HEADER_SIZE];
+        PutU32(header, RECORD_MAGIC);
+        PutU32(header + 4, static_cast<uint32_t>(position.x));
+        PutU32(header + 8, static_cast<uint32_t>(position.y));
+        PutU32(header + 12, static_cast<uint32_t>(position.z));
+        PutU32(header + 16, static_cast<uint32_t>(payload.size()));
+
+        m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        m_file.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+
+        locations.push_back({offset + RECORD_HEADER_SIZE, static_cast<uint32_t>(payload.size())});
+        offset += RECORD_HEADER_SIZE + payload.size();
+    }
+
+    m_file.flush();
+    if (!m_file) {
+        std::cerr << "Failed to write region file: " << m_path << std::endl;
+
+        // Cut off whatever part of the batch reached the file. Left in place,
+        // the next Open() would stop at the torn record and lose every record
+        // appended after it. The index still points at the previous records.
+        m_file.close();
+        m_file.clear();
+        std::error_code error;
+        std::filesystem::resize_file(m_path, m_endOffset, error);
+        if (error) {
+            std::cerr << "Failed to roll back region file " << m_path << ": " << error.message() << std::endl;
+        }
+        m_file.open(m_path, std::ios::in | std::ios::out | std::ios::binary);
+        return false;
+    }
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        const glm::ivec3& position = records[i].first;
+        auto it = m_index.find(position);
+        if (it != m_index.end()) {
+            m_deadBytes += RECORD_HEADER_SIZE + it->second.length;
+            m_liveBytes -= RECORD_HEADER_SIZE + it->second.length;
+        }
+        m_index[position] = locations[i];
+        m_liveBytes += RECORD_HEADER_SIZE + locations[i].length;
+    }
+    m_endOffset = offset;
+    return true;
+}
+
+bool RegionFile::NeedsCompaction() const {
+    return m_deadBytes >= MIN_COMPACTION_WASTE && m_deadBytes > m_liveBytes;
+}
+
+bool RegionFile::Compact() {
+    const std::string tempPath = m_path + ".tmp";
+    std::unordered_map<glm::ivec3, RecordLocation, ivec3Hash> newIndex;
+    uint64_t offset = FILE_HEADER_SIZE;
+
+    // Don't leave a partial image behind; the old file stays valid
+    auto fail = [&tempPath](std::fstream& temp) {
+        std::cerr << "Failed to write compacted region file " << tempPath << std::endl;
+        temp.close();
+        std::error_code error;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    };
+
+    {
+        std::fstream temp(tempPath, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!temp || !WriteHeader(temp)) {
+            return fail(temp);
+        }
+
+        std::vector<uint8_t> payload;
+        for (const auto& [position, location] : m_index) {
+            if (!Read(position, payload)) {
+                return fail(temp);
+            }
+
+            uint8_t header[RECORD_HEADER_SIZE];
+            PutU32(header, RECORD_MAGIC);
+            PutU32(header + 4, static_cast<uint32_t>(position.x));
+            PutU32(header + 8, static_cast<uint32_t>(position.y));
+            PutU32(header + 12, static_cast<uint32_t>(position.z));
+            PutU32(header + 16, location.length);
+
+            temp.write(reinterpret_cast<const char*>(header), sizeof(header));
+            temp.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+
+            newIndex[position] = {offset + RECORD_HEADER_SIZE, location.length};
+            offset += RECORD_HEADER_SIZE + location.length;
+        }
+
+        temp.flush();
+        if (!temp) {
+            return fail(temp);
+        }
+    }
+
+    // Swap the compacted file in. rename() replaces the old file atomically,
+    // so a crash leaves either the old or the new version.
+    m_file.close();
+    std::error_code error;
+    std::filesystem::rename(tempPath, m_path, error);
+    const bool renamed = !error;
+    if (!renamed) {
+        std::filesystem::remove(tempPath, error);
+    }
+
+    m_file.open(m_path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!renamed || !m_file) {
+        std::cerr << "Failed to compact region file: " << m_path << std::endl;
+        return m_file.is_open() && ScanRecords();
+    }
+
+    m_index.swap(newIndex);
+    m_deadBytes = 0;
+    m_liveBytes = offset - FILE_HEADER_SIZE;
+    m_endOffset = offset;
+    return true;
+}
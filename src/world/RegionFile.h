@@ -0,0 +1,78 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "../utils/Math.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// One region file holds every chunk of a REGION_SIZE x REGION_SIZE block of
+// chunk columns. Records are only ever appended; the in-memory index points at
+// the newest record of each chunk, stale records are dropped by Compact().
+// Not thread-safe - owned by the storage I/O thread.
+class RegionFile {
+public:
+    static constexpr int REGION_SIZE = 32; // In chunks, along X and Z
+
+    explicit RegionFile(const std::string& path);
+    ~RegionFile();
+
+    RegionFile(const RegionFile&) = delete;
+    RegionFile& operator=(const RegionFile&) = delete;
+
+    // Opens (or creates) the file and rebuilds the index.
+    // A torn record at the end of the file (crash mid-write) is ignored.
+    bool Open();
+
+    bool Contains(const glm::ivec3& chunkPosition) const { return m_index.count(chunkPosition) > 0; }
+    bool Read(const glm::ivec3& chunkPosition, std::vector<uint8_t>& payload);
+
+    // Appends all records, then flushes once. On failure the file is cut back
+    // to its previous end and the index is unchanged, so the batch can be retried.
+    bool Write(const std::vector<std::pair<glm::ivec3, std::vector<uint8_t>>>& records);
+
+    // Rewrites the file with live records only
+    bool Compact();
+    bool NeedsCompaction() const;
+
+    size_t GetChunkCount() const { return m_index.size(); }
+    uint64_t GetLiveBytes() const { return m_liveBytes; }
+    uint64_t GetDeadBytes() const { return m_deadBytes; }
+
+    static glm::ivec2 GetRegionPosition(const glm::ivec3& chunkPosition) {
+        return glm::ivec2(Math::FloorDiv(chunkPosition.x, REGION_SIZE), Math::FloorDiv(chunkPosition.z, REGION_SIZE));
+    }
+    // "r.<x>.<z>.<extension>", shared by every per-region file type
+    static std::string GetFileName(const glm::ivec2& regionPosition, const char* extension = "vxr");
+    static bool ParseFileName(const std::string& fileName, glm::ivec2& regionPosition, const char* extension = "vxr");
+
+private:
+    static constexpr uint32_t FILE_MAGIC = 0x47525856;   // "VXRG"
+    static constexpr uint32_t FILE_VERSION = 1;
+    static constexpr uint32_t RECORD_MAGIC = 0x43525856; // "VXRC"
+    static constexpr uint64_t FILE_HEADER_SIZE = 8;
+    static constexpr uint64_t RECORD_HEADER_SIZE = 20;   // magic, x, y, z, length
+    static constexpr uint64_t MIN_COMPACTION_WASTE = 256 * 1024;
+
+    struct RecordLocation {
+        uint64_t offset; // Of the payload
+        uint32_t length;
+    };
+
+    bool WriteHeader(std::fstream& file);
+    bool ScanRecords();
+
+    std::string m_path;
+    std::fstream m_file;
+    std::unordered_map<glm::ivec3, RecordLocation, ivec3Hash> m_index;
+    uint64_t m_endOffset = 0;
+    uint64_t m_liveBytes = 0;
+    uint64_t m_deadBytes = 0;
+};
@@ -3,52 +3,37 @@
 //
 
 #include "WorldGenerator.h"
-#include "FastNoiseLite.h"
+#include "ColumnCache.h"
+#include "DensityLattice.h"
+#include "FractalNoise.h"
+#include "../utils/Math.h"
 #include <algorithm>
-#include <random>
 #include <cmath>
 
 WorldGenerator::WorldGenerator() {
-    m_terrainNoise = std::make_unique<FastNoiseLite>();
-    m_detailNoise = std::make_unique<FastNoiseLite>();
-    m_biomeNoise = std::make_unique<FastNoiseLite>();
-    m_caveNoise = std::make_unique<FastNoiseLite>();
     m_treeNoise = std::make_unique<FastNoiseLite>();
     m_oreNoise = std::make_unique<FastNoiseLite>();
+    m_columnCache = std::make_unique<ColumnCache>(COLUMN_CACHE_CAPACITY);
 }
 
 WorldGenerator::~WorldGenerator() = default;
 
 void WorldGenerator::Initialize() {
-    // Main terrain noise
-    m_terrainNoise->SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    m_terrainNoise->SetFrequency(m_settings.terrainScale);
-    m_terrainNoise->SetFractalType(FastNoiseLite::FractalType_FBm);
-    m_terrainNoise->SetFractalOctaves(4);
-    m_terrainNoise->SetFractalLacunarity(2.0f);
-    m_terrainNoise->SetFractalGain(0.5f);
-    m_terrainNoise->SetSeed(TERRAIN_SEED);
+    // Main terrain noise (FBm, lacunarity 2, gain 0.5)
+    m_terrainNoise = std::make_unique<FractalNoise<4>>(
+        FastNoiseLite::NoiseType_OpenSimplex2, TERRAIN_SEED, m_settings.terrainScale);
 
     // Detail noise for terrain variation
-    m_detailNoise->SetNoiseType(FastNoiseLite::NoiseType_Perlin);
-    m_detailNoise->SetFrequency(m_settings.detailScale);
-    m_detailNoise->SetFractalType(FastNoiseLite::FractalType_FBm);
-    m_detailNoise->SetFractalOctaves(3);
-    m_detailNoise->SetSeed(DETAIL_SEED);
+    m_detailNoise = std::make_unique<FractalNoise<3>>(
+        FastNoiseLite::NoiseType_Perlin, DETAIL_SEED, m_settings.detailScale);
 
     // Biome noise
-    m_biomeNoise->SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    m_biomeNoise->SetFrequency(0.003f);
-    m_biomeNoise->SetFractalType(FastNoiseLite::FractalType_FBm);
-    m_biomeNoise->SetFractalOctaves(2);
-    m_biomeNoise->SetSeed(BIOME_SEED);
+    m_biomeNoise = std::make_unique<FractalNoise<2>>(
+        FastNoiseLite::NoiseType_OpenSimplex2, BIOME_SEED, 0.003f);
 
     // Cave noise
-    m_caveNoise->SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    m_caveNoise->SetFrequency(m_settings.caveScale);
-    m_caveNoise->SetFractalType(FastNoiseLite::FractalType_Ridged);
-    m_caveNoise->SetFractalOctaves(2);
-    m_caveNoise->SetSeed(CAVE_SEED);
+    m_caveNoise = std::make_unique<FractalNoise<2>>(
+        FastNoiseLite::NoiseType_OpenSimplex2, CAVE_SEED, m_settings.caveScale, FastNoiseLite::FractalType_Ridged);
 
     // Tree placement noise
     m_treeNoise->SetNoiseType(FastNoiseLite::NoiseType_Cellular);
@@ -63,69 +48,164 @@ void WorldGenerator::Initialize() {
     m_oreNoise->SetSeed(ORE_SEED);
 }
 
-void WorldGenerator::GenerateChunk(Chunk* chunk) {
-    GenerateTerrain(chunk);
+void WorldGenerator::GenerateChunk(Chunk* chunk) const {
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        RunStage(static_cast<Stage>(i), chunk);
+    }
+}
+
+const WorldGenerator::StageInfo& WorldGenerator::GetStageInfo(Stage stage) {
+    static const StageInfo STAGES[STAGE_COUNT] = {
+        {"Shape", 0},
+        {"Carve", 0},
+        {"Surface", 0},
+        {"Decorate", 1}, // Trees rooted in the neighbouring columns
+    };
+    return STAGES[static_cast<size_t>(stage)];
+}
+
+void WorldGenerator::RunStage(Stage stage, Chunk* chunk) const {
+    const glm::ivec3& chunkPos = chunk->GetPosition();
 
-    if (m_settings.generateCaves) {
-        GenerateCaves(chunk);
+    switch (stage) {
+        case Stage::Shape:
+            GenerateShape(chunk, *GetColumn(chunkPos.x, chunkPos.z));
+            break;
+        case Stage::Carve:
+            if (m_settings.generateCaves) {
+                GenerateCaves(chunk, *GetColumn(chunkPos.x, chunkPos.z));
+            }
+            break;
+        case Stage::Surface:
+            GenerateSurface(chunk, *GetColumn(chunkPos.x, chunkPos.z));
+            break;
+        case Stage::Decorate:
+            if (m_settings.generateOres) {
+                GenerateOres(chunk);
+            }
+            if (m_settings.generateTrees) {
+                GenerateTrees(chunk);
+            }
+            break;
+        default:
+            break;
     }
+}
+
+WorldGenerator::ShapeFill WorldGenerator::ClassifyShape(const ColumnSample& column, int chunkY) const {
+    const int bottom = chunkY * Chunk::HEIGHT;
+    const int top = bottom + Chunk::HEIGHT - 1;
 
-    if (m_settings.generateOres) {
-        GenerateOres(chunk);
+    // A block is solid when worldY <= floor(height), see GenerateShape
+    if (bottom > static_cast<int>(std::floor(column.maxHeight))) {
+        if (bottom > m_settings.seaLevel) return ShapeFill::Air;
+        if (top <= m_settings.seaLevel) return ShapeFill::Water;
+        return ShapeFill::Mixed;
     }
 
-    if (m_settings.generateTrees) {
-        GenerateTrees(chunk);
+    if (top <= static_cast<int>(std::floor(column.minHeight))) {
+        return ShapeFill::Stone;
     }
+
+    return ShapeFill::Mixed;
 }
 
-void WorldGenerator::GenerateTerrain(Chunk* chunk) {
+void WorldGenerator::GenerateShape(Chunk* chunk, const ColumnSample& column) const {
     const glm::ivec3& chunkPos = chunk->GetPosition();
-    const glm::vec3& worldPos = chunk->GetWorldPosition();
+
+    // Most chunks of a column are uniform - no per-voxel work for those
+    switch (ClassifyShape(column, chunkPos.y)) {
+        case ShapeFill::Air:   chunk->Fill(BlockType::Air); return;
+        case ShapeFill::Water: chunk->Fill(BlockType::Water); return;
+        case ShapeFill::Stone: chunk->Fill(BlockType::Stone); return;
+        case ShapeFill::Mixed: break;
+    }
 
     for (int x = 0; x < Chunk::SIZE; ++x) {
         for (int z = 0; z < Chunk::SIZE; ++z) {
-            float worldX = worldPos.x + x;
-            float worldZ = worldPos.z + z;
-
-            // Get biome and terrain height
-            BiomeType biome = GetBiome(worldX, worldZ);
-            float terrainHeight = GetTerrainHeight(worldX, worldZ);
-            int heightInt = static_cast<int>(terrainHeight);
+            // Everything at or below the terrain height is stone for now
+            const int solidTop = static_cast<int>(std::floor(column.height[GetColumnIndex(x, z)]));
 
             for (int y = 0; y < Chunk::HEIGHT; ++y) {
                 int worldY = chunkPos.y * Chunk::HEIGHT + y;
 
-                BlockType blockType = GetBlockTypeForHeight(worldY, terrainHeight, biome);
+                BlockType blockType = BlockType::Air;
+                if (worldY <= solidTop) {
+                    blockType = BlockType::Stone;
+                } else if (worldY <= m_settings.seaLevel) {
+                    blockType = BlockType::Water;
+                }
                 chunk->SetBlock(x, y, z, blockType);
             }
         }
     }
 }
 
-void WorldGenerator::GenerateCaves(Chunk* chunk) {
-    const glm::ivec3& chunkPos = chunk->GetPosition();
-    const glm::vec3& worldPos = chunk->GetWorldPosition();
+void WorldGenerator::GenerateSurface(Chunk* chunk, const ColumnSample& column) const {
+    const int bottom = chunk->GetPosition().y * Chunk::HEIGHT;
+    const int top = bottom + Chunk::HEIGHT - 1;
 
-    // Only generate caves below sea level + some margin
-    if (chunkPos.y > 1) return;
+    // No column's top layers reach into the chunk
+    if (bottom > static_cast<int>(std::floor(column.maxHeight)) ||
+        top < static_cast<int>(std::floor(column.minHeight)) - SUBSURFACE_DEPTH) {
+        return;
+    }
 
     for (int x = 0; x < Chunk::SIZE; ++x) {
-        for (int y = 0; y < Chunk::HEIGHT; ++y) {
-            for (int z = 0; z < Chunk::SIZE; ++z) {
-                int worldY = chunkPos.y * Chunk::HEIGHT + y;
-
-                // Don't generate caves too close to surface or too deep
-                if (worldY < 2 || worldY > m_settings.seaLevel + 5) continue;
+        for (int z = 0; z < Chunk::SIZE; ++z) {
+            BiomeType biome = column.biome[GetColumnIndex(x, z)];
+            float terrainHeight = column.height[GetColumnIndex(x, z)];
+
+            // Only the top layers differ from stone; caves carved through them stay open
+            const int solidTop = static_cast<int>(std::floor(terrainHeight));
+            const int minY = std::max(solidTop - SUBSURFACE_DEPTH - bottom, 0);
+            const int maxY = std::min(solidTop - bottom, Chunk::HEIGHT - 1);
+
+            for (int y = minY; y <= maxY; ++y) {
+                BlockType blockType = GetBlockTypeForHeight(bottom + y, terrainHeight, biome);
+                if (blockType != BlockType::Stone && chunk->GetBlock(x, y, z) == BlockType::Stone) {
+                    chunk->SetBlock(x, y, z, blockType);
+                }
+            }
+        }
+    }
+}
 
-                float worldX = worldPos.x + x;
-                float worldZ = worldPos.z + z;
+bool WorldGenerator::BuildCaveDensity(const glm::ivec3& chunkPos, float columnMaxHeight,
+                                      DensityLattice& density, int& minY, int& maxY) const {
+    // Only generate caves below sea level + some margin
+    if (chunkPos.y > 1) return false;
+
+    // Don't generate caves too close to surface or too deep. Only solid
+    // blocks are carved, so rows above the highest surface are skipped too.
+    const int baseY = chunkPos.y * Chunk::HEIGHT;
+    minY = std::max(0, 2 - baseY);
+    maxY = std::min({Chunk::HEIGHT - 1, m_settings.seaLevel + 5 - baseY,
+                     static_cast<int>(std::floor(columnMaxHeight)) - baseY});
+    if (minY > maxY) return false;
+
+    // Cave noise on the coarse lattice; caves are squashed vertically
+    density.Build(chunkPos, minY, maxY, [this](const float* xs, const float* ys, const float* zs,
+                                               size_t count, float* out) {
+        std::array<float, DensityLattice::MAX_POINTS> squashedY;
+        for (size_t i = 0; i < count; ++i) {
+            squashedY[i] = ys[i] * 0.5f;
+        }
+        m_caveNoise->Fill3D(xs, squashedY.data(), zs, count, out);
+    });
+    return true;
+}
 
-                // Generate cave noise
-                float caveValue = m_caveNoise->GetNoise(worldX, worldY * 0.5f, worldZ);
+void WorldGenerator::GenerateCaves(Chunk* chunk, const ColumnSample& column) const {
+    DensityLattice density;
+    int minY = 0, maxY = 0;
+    if (!BuildCaveDensity(chunk->GetPosition(), column.maxHeight, density, minY, maxY)) return;
 
+    for (int y = minY; y <= maxY; ++y) {
+        for (int z = 0; z < Chunk::SIZE; ++z) {
+            for (int x = 0; x < Chunk::SIZE; ++x) {
                 // Create caves where noise is above threshold
-                if (caveValue > m_settings.caveThreshold) {
+                if (density.Get(x, y, z) > m_settings.caveThreshold) {
                     BlockType currentBlock = chunk->GetBlock(x, y, z);
                     if (currentBlock != BlockType::Air && currentBlock != BlockType::Water) {
                         chunk->SetBlock(x, y, z, BlockType::Air);
@@ -136,117 +216,291 @@ void WorldGenerator::GenerateCaves(Chunk* chunk) {
     }
 }
 
-void WorldGenerator::GenerateTrees(Chunk* chunk) {
-    const glm::ivec3& chunkPos = chunk->GetPosition();
-    const glm::vec3& worldPos = chunk->GetWorldPosition();
-
-    // Only generate trees in above-ground chunks
-    if (chunkPos.y < 0) return;
-
-    std::mt19937 rng(chunkPos.x * 73856093 ^ chunkPos.z * 19349663 ^ chunkPos.y * 83492791);
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+template<typename Visitor>
+void WorldGenerator::ForEachTreeReaching(int chunkX, int chunkZ, Visitor&& visit) const {
+    for (int dz = -1; dz <= 1; ++dz) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            std::shared_ptr<const ColumnSample> column = GetColumn(chunkX + dx, chunkZ + dz);
+
+            for (const TreeSite& site : column->trees) {
+                int localX = site.x + dx * Chunk::SIZE;
+                int localZ = site.z + dz * Chunk::SIZE;
+                if (localX >= -TREE_RADIUS && localX < Chunk::SIZE + TREE_RADIUS &&
+                    localZ >= -TREE_RADIUS && localZ < Chunk::SIZE + TREE_RADIUS) {
+                    visit(site, localX, localZ);
+                }
+            }
+        }
+    }
+}
 
-    for (int x = 2; x < Chunk::SIZE - 2; ++x) {
-        for (int z = 2; z < Chunk::SIZE - 2; ++z) {
-            float worldX = worldPos.x + x;
-            float worldZ = worldPos.z + z;
+void WorldGenerator::GenerateTrees(Chunk* chunk) const {
+    const glm::ivec3& chunkPos = chunk->GetPosition();
+    const int bottom = chunkPos.y * Chunk::HEIGHT;
+    const int top = bottom + Chunk::HEIGHT - 1;
 
-            BiomeType biome = GetBiome(worldX, worldZ);
+    // Trees only grow on dry land
+    if (top <= m_settings.seaLevel) return;
 
-            // Skip tree generation in desert and ocean biomes
-            if (biome == BiomeType::Desert || biome == BiomeType::Ocean) {
-                continue;
-            }
+    ForEachTreeReaching(chunkPos.x, chunkPos.z, [&](const TreeSite& site, int localX, int localZ) {
+        // The tree spans baseY .. surface + TREE_CLEARANCE
+        if (site.baseY > top || site.baseY + TREE_CLEARANCE - 1 < bottom) {
+            return;
+        }
 
-            // Check tree noise
-            float treeValue = m_treeNoise->GetNoise(worldX, worldZ);
-            float treeChance = 0.1f;
+        glm::ivec3 base(localX, site.baseY - bottom, localZ);
+        glm::ivec3 worldBase(chunkPos.x * Chunk::SIZE + localX, site.baseY, chunkPos.z * Chunk::SIZE + localZ);
+        PlaceTree(chunk, base, worldBase, site.biome);
+    });
+}
 
-            // Adjust tree chance based on biome
-            switch (biome) {
-                case BiomeType::Forest: treeChance = 0.3f; break;
-                case BiomeType::Plains: treeChance = 0.05f; break;
-                case BiomeType::Mountains: treeChance = 0.15f; break;
-                default: break;
-            }
+void WorldGenerator::GenerateOres(Chunk* chunk) const {
+    const glm::ivec3& chunkPos = chunk->GetPosition();
 
-            if (treeValue > 0.7f && dist(rng) < treeChance) {
-                // Find surface block
-                for (int y = Chunk::HEIGHT - 1; y >= 0; --y) {
-                    BlockType surfaceBlock = chunk->GetBlock(x, y, z);
-                    if (surfaceBlock == BlockType::Grass || surfaceBlock == BlockType::Dirt) {
-                        // Place tree
-                        if (y + 6 < Chunk::HEIGHT) {
-                            PlaceTree(chunk, x, y + 1, z, biome);
-                        }
-                        break;
-                    }
-                }
+    // One potential vein per chunk-sized cell of the world. A vein reaches
+    // VEIN_RADIUS past its cell, so the 3x3x3 cells around the chunk can touch it.
+    for (int cellY = chunkPos.y - 1; cellY <= chunkPos.y + 1; ++cellY) {
+        // Iron ore (common, mid-depth)
+        int worldY = cellY * Chunk::HEIGHT;
+        if (worldY < -32 || worldY > -8) continue;
+
+        for (int cellZ = chunkPos.z - 1; cellZ <= chunkPos.z + 1; ++cellZ) {
+            for (int cellX = chunkPos.x - 1; cellX <= chunkPos.x + 1; ++cellX) {
+                const glm::ivec3 cell(cellX, cellY, cellZ);
+                if (Math::HashFloat(ORE_SEED, cell, SALT_ORE_CHANCE) >= 0.3f) continue;
+
+                glm::ivec3 center(cellX * Chunk::SIZE + Math::HashRange(ORE_SEED, cell, SALT_ORE_CENTER, 0, Chunk::SIZE - 1),
+                                  worldY + Math::HashRange(ORE_SEED, cell, SALT_ORE_CENTER + 1, 0, Chunk::HEIGHT - 1),
+                                  cellZ * Chunk::SIZE + Math::HashRange(ORE_SEED, cell, SALT_ORE_CENTER + 2, 0, Chunk::SIZE - 1));
+                int size = Math::HashRange(ORE_SEED, cell, SALT_ORE_SIZE, 2, 6);
+                PlaceOreVein(chunk, BlockType::Stone, center, size); // Using stone as placeholder
             }
         }
     }
 }
 
-void WorldGenerator::GenerateOres(Chunk* chunk) {
-    const glm::ivec3& chunkPos = chunk->GetPosition();
-    const glm::vec3& worldPos = chunk->GetWorldPosition();
+bool WorldGenerator::HasColumn(int chunkX, int chunkZ) const {
+    return m_columnCache->Contains(glm::ivec2(chunkX, chunkZ));
+}
 
-    // Only generate ores underground
-    if (chunkPos.y > 0) return;
+std::shared_ptr<const WorldGenerator::ColumnSample> WorldGenerator::GetColumn(int chunkX, int chunkZ) const {
+    const glm::ivec2 key(chunkX, chunkZ);
+    if (std::shared_ptr<const ColumnSample> cached = m_columnCache->Find(key)) {
+        return cached;
+    }
+
+    auto column = std::make_shared<ColumnSample>();
+    SampleColumn(chunkX, chunkZ, *column);
+    return m_columnCache->Insert(key, std::move(column));
+}
 
-    std::mt19937 rng(chunkPos.x * 73856093 ^ chunkPos.z * 19349663 ^ chunkPos.y * 83492791);
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-    std::uniform_int_distribution<int> sizeDist(2, 6);
-    std::uniform_int_distribution<int> posDist(0, Chunk::SIZE - 1);
+WorldGenerator::ColumnBounds WorldGenerator::GetColumnBounds(int chunkX, int chunkZ) const {
+    std::shared_ptr<const ColumnSample> column = GetColumn(chunkX, chunkZ);
 
-    // Generate different ore types based on depth
-    int worldY = chunkPos.y * Chunk::HEIGHT;
+    ColumnBounds bounds;
+    bounds.minSurface = static_cast<int>(std::floor(column->minHeight));
+    bounds.maxContent = std::max(static_cast<int>(std::ceil(column->maxHeight)) + TREE_CLEARANCE, m_settings.seaLevel);
 
-    // Iron ore (common, mid-depth)
-    if (worldY >= -32 && worldY <= -8 && dist(rng) < 0.3f) {
-        int x = posDist(rng);
-        int y = posDist(rng);
-        int z = posDist(rng);
-        PlaceOreVein(chunk, BlockType::Stone, x, y, z, sizeDist(rng)); // Using stone as placeholder
+    // Trees rooted next to the column can reach over higher ground than its own
+    if (m_settings.generateTrees) {
+        ForEachTreeReaching(chunkX, chunkZ, [&bounds](const TreeSite& site, int, int) {
+            bounds.maxContent = std::max(bounds.maxContent, site.baseY + TREE_CLEARANCE - 1);
+        });
     }
+    return bounds;
 }
 
-float WorldGenerator::GetTerrainHeight(float x, float z) {
-    BiomeType biome = GetBiome(x, z);
+WorldGenerator::ChunkContent WorldGenerator::ClassifyChunk(const ColumnBounds& bounds, int chunkY) const {
+    const int bottom = chunkY * Chunk::HEIGHT;
+    const int top = bottom + Chunk::HEIGHT - 1;
 
-    // Base terrain height
-    float baseHeight = m_terrainNoise->GetNoise(x, z) * m_settings.terrainHeight;
+    if (bottom > bounds.maxContent) {
+        return ChunkContent::Empty;
+    }
 
-    // Detail noise
-    float detail = m_detailNoise->GetNoise(x, z) * m_settings.detailHeight;
+    // Same range GenerateCaves carves
+    const bool mayHaveCaves = m_settings.generateCaves && chunkY <= 1 &&
+                              top >= 2 && bottom <= m_settings.seaLevel + 5;
 
-    // Biome-specific modifications
-    float biomeModifier = GetBiomeHeight(x, z, biome);
+    if (top < bounds.minSurface - SUBSURFACE_DEPTH && !mayHaveCaves) {
+        return ChunkContent::Buried;
+    }
 
-    return m_settings.seaLevel + baseHeight + detail + biomeModifier;
+    return ChunkContent::Surface;
 }
 
-float WorldGenerator::GetBiomeHeight(float x, float z, BiomeType biome) {
-    switch (biome) {
-        case BiomeType::Mountains:
-            return m_terrainNoise->GetNoise(x * 0.003f, z * 0.003f) * 32.0f;
-        case BiomeType::Ocean:
-            return -8.0f;
-        case BiomeType::Desert:
-            return m_detailNoise->GetNoise(x * 0.02f, z * 0.02f) * 4.0f;
-        case BiomeType::Plains:
-            return 0.0f;
-        case BiomeType::Forest:
-            return m_detailNoise->GetNoise(x * 0.01f, z * 0.01f) * 6.0f;
-        default:
-            return 0.0f;
+void WorldGenerator::SampleColumn(int chunkX, int chunkZ, ColumnSample& column) const {
+    std::array<float, COLUMN_AREA> xs, zs;
+    for (int z = 0; z < Chunk::SIZE; ++z) {
+        for (int x = 0; x < Chunk::SIZE; ++x) {
+            int i = GetColumnIndex(x, z);
+            xs[i] = static_cast<float>(chunkX * Chunk::SIZE + x);
+            zs[i] = static_cast<float>(chunkZ * Chunk::SIZE + z);
+        }
+    }
+
+    // Biomes vary over hundreds of blocks - sample them every BIOME_CELL blocks.
+    // Grid points sit on world multiples of BIOME_CELL, so neighbouring columns
+    // agree on their shared edge.
+    std::array<float, BIOME_GRID_AREA> gridX, gridZ, scaledX, scaledZ;
+    for (int gz = 0; gz < BIOME_GRID_POINTS; ++gz) {
+        for (int gx = 0; gx < BIOME_GRID_POINTS; ++gx) {
+            int g = gz * BIOME_GRID_POINTS + gx;
+            gridX[g] = static_cast<float>(chunkX * Chunk::SIZE + gx * BIOME_CELL);
+            gridZ[g] = static_cast<float>(chunkZ * Chunk::SIZE + gz * BIOME_CELL);
+            scaledX[g] = gridX[g] * 1.5f;
+            scaledZ[g] = gridZ[g] * 1.5f;
+        }
+    }
+
+    // Biome: two samples of the biome noise, the second at 1.5x as temperature
+    std::array<float, BIOME_GRID_AREA> biomeValue, temperatureValue;
+    std::array<BiomeType, BIOME_GRID_AREA> gridBiome;
+    m_biomeNoise->Fill2D(gridX.data(), gridZ.data(), BIOME_GRID_AREA, biomeValue.data());
+    m_biomeNoise->Fill2D(scaledX.data(), scaledZ.data(), BIOME_GRID_AREA, temperatureValue.data());
+    for (int g = 0; g < BIOME_GRID_AREA; ++g) {
+        gridBiome[g] = SelectBiome(biomeValue[g], temperatureValue[g]);
+    }
+
+    // Height modifier of each grid point's biome, evaluated only for the points of that biome
+    std::array<float, BIOME_GRID_AREA> gridModifier{};
+    std::array<int, BIOME_GRID_AREA> lanes;
+    auto sampleModifier = [&](BiomeType biome, const auto& noise, float scale, float amplitude) {
+        size_t count = 0;
+        for (int g = 0; g < BIOME_GRID_AREA; ++g) {
+            if (gridBiome[g] == biome) {
+                lanes[count] = g;
+                scaledX[count] = gridX[g] * scale;
+                scaledZ[count] = gridZ[g] * scale;
+                count++;
+            }
+        }
+        if (count == 0) return;
+
+        std::array<float, BIOME_GRID_AREA> values;
+        noise.Fill2D(scaledX.data(), scaledZ.data(), count, values.data());
+        for (size_t j = 0; j < count; ++j) {
+            gridModifier[lanes[j]] = values[j] * amplitude;
+        }
+    };
+    sampleModifier(BiomeType::Mountains, *m_terrainNoise, 0.003f, 32.0f);
+    sampleModifier(BiomeType::Desert, *m_detailNoise, 0.02f, 4.0f);
+    sampleModifier(BiomeType::Forest, *m_detailNoise, 0.01f, 6.0f);
+    for (int g = 0; g < BIOME_GRID_AREA; ++g) {
+        if (gridBiome[g] == BiomeType::Ocean) {
+            gridModifier[g] = -8.0f;
+        }
+    }
+
+    // Blocks interpolate between the four grid points around them: the biome
+    // from the interpolated noise, and the modifiers themselves, so terrain
+    // ramps between biomes instead of stepping at their border
+    std::array<float, COLUMN_AREA> biomeModifier;
+    for (int z = 0; z < Chunk::SIZE; ++z) {
+        for (int x = 0; x < Chunk::SIZE; ++x) {
+            int i = GetColumnIndex(x, z);
+            int g = (z / BIOME_CELL) * BIOME_GRID_POINTS + x / BIOME_CELL;
+            float fx = static_cast<float>(x % BIOME_CELL) / BIOME_CELL;
+            float fz = static_cast<float>(z % BIOME_CELL) / BIOME_CELL;
+
+            auto interpolate = [g, fx, fz](const std::array<float, BIOME_GRID_AREA>& grid) {
+                float near = Math::Lerp(grid[g], grid[g + 1], fx);
+                float far = Math::Lerp(grid[g + BIOME_GRID_POINTS], grid[g + BIOME_GRID_POINTS + 1], fx);
+                return Math::Lerp(near, far, fz);
+            };
+
+            column.biome[i] = SelectBiome(interpolate(biomeValue), interpolate(temperatureValue));
+            biomeModifier[i] = interpolate(gridModifier);
+        }
+    }
+
+    // Base terrain and detail
+    std::array<float, COLUMN_AREA> baseNoise, detailNoise;
+    m_terrainNoise->Fill2D(xs.data(), zs.data(), COLUMN_AREA, baseNoise.data());
+    m_detailNoise->Fill2D(xs.data(), zs.data(), COLUMN_AREA, detailNoise.data());
+
+    for (int i = 0; i < COLUMN_AREA; ++i) {
+        float baseHeight = baseNoise[i] * m_settings.terrainHeight;
+        float detail = detailNoise[i] * m_settings.detailHeight;
+        column.height[i] = m_settings.seaLevel + baseHeight + detail + biomeModifier[i];
     }
+
+    auto range = std::minmax_element(column.height.begin(), column.height.end());
+    column.minHeight = *range.first;
+    column.maxHeight = *range.second;
+
+    FindTreeSites(chunkX, chunkZ, column);
 }
 
-WorldGenerator::BiomeType WorldGenerator::GetBiome(float x, float z) {
-    float biomeValue = m_biomeNoise->GetNoise(x, z);
-    float temperatureValue = m_biomeNoise->GetNoise(x * 1.5f, z * 1.5f);
+void WorldGenerator::FindTreeSites(int chunkX, int chunkZ, ColumnSample& column) const {
+    column.trees.clear();
+    if (!m_settings.generateTrees) return;
+
+    // Cave lattice of the chunk holding the current surface block, built on
+    // demand - only the few sites that pass the chance checks need it
+    DensityLattice caveDensity;
+    int caveChunkY = 0;
+    bool caveChunkBuilt = false;
+    bool hasCaves = false;
+    int caveMinY = 0, caveMaxY = 0;
+
+    for (int z = 0; z < Chunk::SIZE; ++z) {
+        for (int x = 0; x < Chunk::SIZE; ++x) {
+            int i = GetColumnIndex(x, z);
+            BiomeType biome = column.biome[i];
+
+            // Skip tree generation in desert and ocean biomes
+            if (biome == BiomeType::Desert || biome == BiomeType::Ocean) {
+                continue;
+            }
+
+            // Same surface block GetBlockTypeForHeight places; no trees under water
+            int surfaceY = static_cast<int>(column.height[i]);
+            if (surfaceY < m_settings.seaLevel) {
+                continue;
+            }
+
+            // Adjust tree chance based on biome
+            float treeChance = 0.1f;
+            switch (biome) {
+                case BiomeType::Forest: treeChance = 0.3f; break;
+                case BiomeType::Plains: treeChance = 0.05f; break;
+                case BiomeType::Mountains: treeChance = 0.15f; break;
+                default: break;
+            }
+
+            // The cheap hash first, the cellular noise only for the survivors
+            const glm::ivec3 worldPos(chunkX * Chunk::SIZE + x, 0, chunkZ * Chunk::SIZE + z);
+            if (Math::HashFloat(TREE_SEED, worldPos, SALT_TREE_CHANCE) >= treeChance) {
+                continue;
+            }
+            if (m_treeNoise->GetNoise(static_cast<float>(worldPos.x), static_cast<float>(worldPos.z)) <= 0.7f) {
+                continue;
+            }
+
+            // A surface block carved by a cave leaves nothing to stand on.
+            // Same lattice and rows as GenerateCaves, so the answer is exact.
+            if (m_settings.generateCaves) {
+                const int chunkY = Math::FloorDiv(surfaceY, Chunk::HEIGHT);
+                if (!caveChunkBuilt || chunkY != caveChunkY) {
+                    caveChunkY = chunkY;
+                    caveChunkBuilt = true;
+                    hasCaves = BuildCaveDensity(glm::ivec3(chunkX, chunkY, chunkZ), column.maxHeight,
+                                                caveDensity, caveMinY, caveMaxY);
+                }
+                const int localY = surfaceY - chunkY * Chunk::HEIGHT;
+                if (hasCaves && localY >= caveMinY && localY <= caveMaxY &&
+                    caveDensity.Get(x, localY, z) > m_settings.caveThreshold) {
+                    continue;
+                }
+            }
+
+            column.trees.push_back(TreeSite{x, z, surfaceY + 1, biome});
+        }
+    }
+}
 
+WorldGenerator::BiomeType WorldGenerator::SelectBiome(float biomeValue, float temperatureValue) {
     // Combine noise values to determine biome
     if (biomeValue < -0.4f) {
         return BiomeType::Ocean;
@@ -261,7 +515,7 @@ WorldGenerator::BiomeType WorldGenerator::GetBiome(float x, float z) {
     }
 }
 
-BlockType WorldGenerator::GetBlockTypeForHeight(int worldY, float terrainHeight, BiomeType biome) {
+BlockType WorldGenerator::GetBlockTypeForHeight(int worldY, float terrainHeight, BiomeType biome) const {
     if (worldY > terrainHeight) {
         // Above terrain
         if (worldY <= m_settings.seaLevel) {
@@ -280,7 +534,7 @@ BlockType WorldGenerator::GetBlockTypeForHeight(int worldY, float terrainHeight,
     }
 }
 
-BlockType WorldGenerator::GetSurfaceBlock(BiomeType biome) {
+BlockType WorldGenerator::GetSurfaceBlock(BiomeType biome) const {
     switch (biome) {
         case BiomeType::Desert: return BlockType::Sand;
         case BiomeType::Ocean: return BlockType::Sand;
@@ -289,7 +543,7 @@ BlockType WorldGenerator::GetSurfaceBlock(BiomeType biome) {
     }
 }
 
-BlockType WorldGenerator::GetSubSurfaceBlock(BiomeType biome) {
+BlockType WorldGenerator::GetSubSurfaceBlock(BiomeType biome) const {
     switch (biome) {
         case BiomeType::Desert: return BlockType::Sand;
         case BiomeType::Ocean: return BlockType::Sand;
@@ -297,111 +551,97 @@ BlockType WorldGenerator::GetSubSurfaceBlock(BiomeType biome) {
     }
 }
 
-void WorldGenerator::PlaceTree(Chunk* chunk, int x, int y, int z, BiomeType biome) {
+namespace {
+    // Writes a block of a feature if it falls inside the chunk
+    void PlaceFeatureBlock(Chunk* chunk, int x, int y, int z, BlockType type, bool onlyIntoAir) {
+        if (x < 0 || x >= Chunk::SIZE || y < 0 || y >= Chunk::HEIGHT || z < 0 || z >= Chunk::SIZE) {
+            return;
+        }
+        if (!onlyIntoAir || chunk->GetBlock(x, y, z) == BlockType::Air) {
+            chunk->SetBlock(x, y, z, type);
+        }
+    }
+}
+
+void WorldGenerator::PlaceTree(Chunk* chunk, const glm::ivec3& base, const glm::ivec3& worldBase, BiomeType biome) const {
     switch (biome) {
         case BiomeType::Forest:
         case BiomeType::Mountains:
-            PlacePineTree(chunk, x, y, z);
+            PlacePineTree(chunk, base, Math::HashRange(TREE_SEED, worldBase, SALT_TREE_HEIGHT, 6, 9));
             break;
         case BiomeType::Desert:
-            PlaceCactus(chunk, x, y, z);
+            PlaceCactus(chunk, base, Math::HashRange(TREE_SEED, worldBase, SALT_TREE_HEIGHT, 2, 4));
             break;
         default:
-            PlaceOakTree(chunk, x, y, z);
+            PlaceOakTree(chunk, base, Math::HashRange(TREE_SEED, worldBase, SALT_TREE_HEIGHT, 4, 6));
             break;
     }
 }
 
-void WorldGenerator::PlaceOakTree(Chunk* chunk, int x, int y, int z) {
+void WorldGenerator::PlaceOakTree(Chunk* chunk, const glm::ivec3& base, int trunkHeight) const {
     // Tree trunk
-    int trunkHeight = 4 + (rand() % 3);
     for (int h = 0; h < trunkHeight; ++h) {
-        if (y + h < Chunk::HEIGHT) {
-            chunk->SetBlock(x, y + h, z, BlockType::Wood);
-        }
+        PlaceFeatureBlock(chunk, base.x, base.y + h, base.z, BlockType::Wood, false);
     }
 
     // Tree leaves (simple sphere shape)
-    int leavesStart = y + trunkHeight - 2;
-    int leavesEnd = y + trunkHeight + 2;
+    int leavesStart = base.y + trunkHeight - 2;
+    int leavesEnd = base.y + trunkHeight + 2;
 
-    for (int ly = leavesStart; ly <= leavesEnd && ly < Chunk::HEIGHT; ++ly) {
+    for (int ly = leavesStart; ly <= leavesEnd; ++ly) {
         int radius = 2;
         if (ly == leavesEnd) radius = 1;
 
         for (int lx = -radius; lx <= radius; ++lx) {
             for (int lz = -radius; lz <= radius; ++lz) {
                 if (lx * lx + lz * lz <= radius * radius) {
-                    int px = x + lx;
-                    int pz = z + lz;
-
-                    if (px >= 0 && px < Chunk::SIZE && pz >= 0 && pz < Chunk::SIZE) {
-                        if (chunk->GetBlock(px, ly, pz) == BlockType::Air) {
-                            chunk->SetBlock(px, ly, pz, BlockType::Leaves);
-                        }
-                    }
+                    PlaceFeatureBlock(chunk, base.x + lx, ly, base.z + lz, BlockType::Leaves, true);
                 }
             }
         }
     }
 }
 
-void WorldGenerator::PlacePineTree(Chunk* chunk, int x, int y, int z) {
+void WorldGenerator::PlacePineTree(Chunk* chunk, const glm::ivec3& base, int trunkHeight) const {
     // Taller, thinner tree
-    int trunkHeight = 6 + (rand() % 4);
     for (int h = 0; h < trunkHeight; ++h) {
-        if (y + h < Chunk::HEIGHT) {
-            chunk->SetBlock(x, y + h, z, BlockType::Wood);
-        }
+        PlaceFeatureBlock(chunk, base.x, base.y + h, base.z, BlockType::Wood, false);
     }
 
     // Conical leaves
     for (int layer = 0; layer < 4; ++layer) {
-        int ly = y + trunkHeight - 1 - layer;
-        if (ly >= Chunk::HEIGHT) continue;
-
+        int ly = base.y + trunkHeight - 1 - layer;
         int radius = 1 + (layer / 2);
 
         for (int lx = -radius; lx <= radius; ++lx) {
             for (int lz = -radius; lz <= radius; ++lz) {
-                if (abs(lx) + abs(lz) <= radius) {
-                    int px = x + lx;
-                    int pz = z + lz;
-
-                    if (px >= 0 && px < Chunk::SIZE && pz >= 0 && pz < Chunk::SIZE) {
-                        if (chunk->GetBlock(px, ly, pz) == BlockType::Air) {
-                            chunk->SetBlock(px, ly, pz, BlockType::Leaves);
-                        }
-                    }
+                if (std::abs(lx) + std::abs(lz) <= radius) {
+                    PlaceFeatureBlock(chunk, base.x + lx, ly, base.z + lz, BlockType::Leaves, true);
                 }
             }
         }
     }
 }
 
-void WorldGenerator::PlaceCactus(Chunk* chunk, int x, int y, int z) {
+void WorldGenerator::PlaceCactus(Chunk* chunk, const glm::ivec3& base, int cactusHeight) const {
     // Simple cactus
-    int cactusHeight = 2 + (rand() % 3);
     for (int h = 0; h < cactusHeight; ++h) {
-        if (y + h < Chunk::HEIGHT) {
-            chunk->SetBlock(x, y + h, z, BlockType::Leaves); // Using leaves as cactus placeholder
-        }
+        PlaceFeatureBlock(chunk, base.x, base.y + h, base.z, BlockType::Leaves, false); // Using leaves as cactus placeholder
     }
 }
 
-void WorldGenerator::PlaceOreVein(Chunk* chunk, BlockType oreType, int centerX, int centerY, int centerZ, int size) {
-    std::mt19937 rng(centerX * 73856093 ^ centerY * 19349663 ^ centerZ * 83492791);
-    std::uniform_int_distribution<int> offsetDist(-1, 1);
+void WorldGenerator::PlaceOreVein(Chunk* chunk, BlockType oreType, const glm::ivec3& center, int size) const {
+    const glm::ivec3 origin = chunk->GetPosition() * glm::ivec3(Chunk::SIZE, Chunk::HEIGHT, Chunk::SIZE);
 
     for (int i = 0; i < size; ++i) {
-        int x = centerX + offsetDist(rng);
-        int y = centerY + offsetDist(rng);
-        int z = centerZ + offsetDist(rng);
-
-        if (x >= 0 && x < Chunk::SIZE && y >= 0 && y < Chunk::HEIGHT && z >= 0 && z < Chunk::SIZE) {
-            if (chunk->GetBlock(x, y, z) == BlockType::Stone) {
-                chunk->SetBlock(x, y, z, oreType);
-            }
+        const uint32_t salt = SALT_ORE_BLOCK + 3 * i;
+        glm::ivec3 block = center - origin + glm::ivec3(Math::HashRange(ORE_SEED, center, salt, -VEIN_RADIUS, VEIN_RADIUS),
+                                                        Math::HashRange(ORE_SEED, center, salt + 1, -VEIN_RADIUS, VEIN_RADIUS),
+                                                        Math::HashRange(ORE_SEED, center, salt + 2, -VEIN_RADIUS, VEIN_RADIUS));
+
+        // Out-of-chunk positions read as Air and are left to the neighbour
+        if (chunk->GetBlock(block.x, block.y, block.z) == BlockType::Stone) {
+            chunk->SetBlock(block.x, block.y, block.z, oreType);
         }
     }
-}
\ No newline at end of file
+}
@@ -5,10 +5,17 @@
 #pragma once
 
 #include "Chunk.h"
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
 #include <memory>
+#include <vector>
 
-// Forward declaration
+// Forward declarations
 class FastNoiseLite;
+class ColumnCache;
+class DensityLattice;
+template<int Octaves> class FractalNoise;
 
 class WorldGenerator {
 public:
@@ -16,7 +23,36 @@ public:
     ~WorldGenerator();
 
     void Initialize();
-    void GenerateChunk(Chunk* chunk);
+
+    // Safe to call from several threads at once after Initialize():
+    // generation reads the noise generators and the locked column cache,
+    // and every random decision is a hash of the world position (Math::Hash).
+    // Runs every stage in order; GenerationPipeline schedules them separately.
+    void GenerateChunk(Chunk* chunk) const;
+
+    // Chunk generation stages, in order. Each one runs on a chunk that went
+    // through all the earlier ones.
+    enum class Stage : uint8_t {
+        Shape,    // Stone and water from the column heights
+        Carve,    // Caves
+        Surface,  // Biome surface and subsurface blocks on what is left
+        Decorate, // Ores and trees, including neighbours' trees reaching in
+        Count
+    };
+
+    static constexpr size_t STAGE_COUNT = static_cast<size_t>(Stage::Count);
+
+    struct StageInfo {
+        const char* name;
+        // Column samples the stage reads, as a radius in chunks around the
+        // chunk's own column (Decorate needs the 3x3 tree sites)
+        int columnRadius;
+    };
+
+    static const StageInfo& GetStageInfo(Stage stage);
+
+    // Thread-safe like GenerateChunk
+    void RunStage(Stage stage, Chunk* chunk) const;
 
     // Biome system
     enum class BiomeType {
@@ -27,6 +63,53 @@ public:
         Ocean
     };
 
+    // Height range of a chunk column, from the same height function the
+    // terrain uses (exact for the terrain, conservative for decorations)
+    struct ColumnBounds {
+        int minSurface = 0; // Lowest surface block in the column
+        int maxContent = 0; // Highest block that can be non-Air (terrain, water, trees)
+    };
+
+    // What a chunk of a column can contain, decided from ColumnBounds alone
+    enum class ChunkContent {
+        Empty,   // Entirely above maxContent - all Air
+        Buried,  // Entirely solid stone below every surface, no caves - never visible
+        Surface  // Anything else
+    };
+
+    static constexpr int COLUMN_AREA = Chunk::SIZE * Chunk::SIZE;
+
+    // A tree decided from its world position alone. Every chunk it overlaps
+    // writes its own part, so trees are never cut at chunk borders.
+    struct TreeSite {
+        int x = 0;     // Block column inside the chunk column
+        int z = 0;
+        int baseY = 0; // World height of the lowest trunk block
+        BiomeType biome = BiomeType::Plains;
+    };
+
+    // 2D fields of one chunk column, indexed by GetColumnIndex(x, z)
+    struct ColumnSample {
+        std::array<float, COLUMN_AREA> height;
+        std::array<BiomeType, COLUMN_AREA> biome;
+        float minHeight = 0.0f;      // Height range over the whole column
+        float maxHeight = 0.0f;
+        std::vector<TreeSite> trees; // Trees rooted in this column
+    };
+
+    static int GetColumnIndex(int x, int z) { return z * Chunk::SIZE + x; }
+
+    // Thread-safe. Sampled once per column and shared by all of its vertical
+    // chunks through an LRU cache.
+    std::shared_ptr<const ColumnSample> GetColumn(int chunkX, int chunkZ) const;
+    // True when the column is sampled and cached; GetColumn won't sample it again
+    bool HasColumn(int chunkX, int chunkZ) const;
+    const ColumnCache& GetColumnCache() const { return *m_columnCache; }
+
+    // Thread-safe like GenerateChunk. Reads the cached column sample.
+    ColumnBounds GetColumnBounds(int chunkX, int chunkZ) const;
+    ChunkContent ClassifyChunk(const ColumnBounds& bounds, int chunkY) const;
+
     // Generation settings
     struct GenerationSettings {
         float terrainScale = 0.008f;
@@ -44,42 +127,87 @@ public:
     };
 
 private:
-    void GenerateTerrain(Chunk* chunk);
-    void GenerateCaves(Chunk* chunk);
-    void GenerateTrees(Chunk* chunk);
-    void GenerateOres(Chunk* chunk);
-    void GenerateStructures(Chunk* chunk);
+    // What the Shape stage writes into a chunk, decided from the column's
+    // height range before touching any voxel
+    enum class ShapeFill {
+        Air,   // Above every surface and the sea
+        Water, // Above every surface, entirely below sea level
+        Stone, // Below every surface
+        Mixed  // Crosses a surface or the sea level - per-voxel pass
+    };
+
+    ShapeFill ClassifyShape(const ColumnSample& column, int chunkY) const;
+
+    void GenerateShape(Chunk* chunk, const ColumnSample& column) const;
+    void GenerateCaves(Chunk* chunk, const ColumnSample& column) const;
+    // Cave density over the local rows [minY, maxY] of a chunk that caves
+    // may carve; false when there are none
+    bool BuildCaveDensity(const glm::ivec3& chunkPos, float columnMaxHeight,
+                          DensityLattice& density, int& minY, int& maxY) const;
+    void GenerateSurface(Chunk* chunk, const ColumnSample& column) const;
+    void GenerateTrees(Chunk* chunk) const;
+    void GenerateOres(Chunk* chunk) const;
+    void GenerateStructures(Chunk* chunk) const;
+
+    // Terrain height and biome of every block column, each noise layer
+    // evaluated for the whole 16x16 grid in one batch; biomes and their
+    // height modifiers on the coarse biome grid, interpolated per block
+    void SampleColumn(int chunkX, int chunkZ, ColumnSample& column) const;
+    void FindTreeSites(int chunkX, int chunkZ, ColumnSample& column) const;
+    static BiomeType SelectBiome(float biomeValue, float temperatureValue);
 
-    // Terrain height calculation
-    float GetTerrainHeight(float x, float z);
-    float GetBiomeHeight(float x, float z, BiomeType biome);
-    BiomeType GetBiome(float x, float z);
+    // Calls visit(site, localX, localZ) for every tree of the 3x3 columns
+    // around (chunkX, chunkZ) that reaches into it; local coordinates are
+    // relative to that column and may lie outside it
+    template<typename Visitor>
+    void ForEachTreeReaching(int chunkX, int chunkZ, Visitor&& visit) const;
 
     // Block type determination
-    BlockType GetBlockTypeForHeight(int worldY, float terrainHeight, BiomeType biome);
-    BlockType GetSurfaceBlock(BiomeType biome);
-    BlockType GetSubSurfaceBlock(BiomeType biome);
-
-    // Structure generation
-    void PlaceTree(Chunk* chunk, int x, int y, int z, BiomeType biome);
-    void PlaceOakTree(Chunk* chunk, int x, int y, int z);
-    void PlacePineTree(Chunk* chunk, int x, int y, int z);
-    void PlaceCactus(Chunk* chunk, int x, int y, int z);
-
-    // Ore generation
-    void PlaceOreVein(Chunk* chunk, BlockType oreType, int centerX, int centerY, int centerZ, int size);
-
-    // Noise generators
-    std::unique_ptr<FastNoiseLite> m_terrainNoise;
-    std::unique_ptr<FastNoiseLite> m_detailNoise;
-    std::unique_ptr<FastNoiseLite> m_biomeNoise;
-    std::unique_ptr<FastNoiseLite> m_caveNoise;
+    BlockType GetBlockTypeForHeight(int worldY, float terrainHeight, BiomeType biome) const;
+    BlockType GetSurfaceBlock(BiomeType biome) const;
+    BlockType GetSubSurfaceBlock(BiomeType biome) const;
+
+    // Structure generation. Positions are chunk-local and may lie outside
+    // the chunk; only the blocks inside it are written.
+    void PlaceTree(Chunk* chunk, const glm::ivec3& base, const glm::ivec3& worldBase, BiomeType biome) const;
+    void PlaceOakTree(Chunk* chunk, const glm::ivec3& base, int trunkHeight) const;
+    void PlacePineTree(Chunk* chunk, const glm::ivec3& base, int trunkHeight) const;
+    void PlaceCactus(Chunk* chunk, const glm::ivec3& base, int cactusHeight) const;
+
+    // Ore generation, center in world coordinates
+    void PlaceOreVein(Chunk* chunk, BlockType oreType, const glm::ivec3& center, int size) const;
+
+    // Noise generators. Fractal layers are batched, octave counts are fixed here.
+    std::unique_ptr<FractalNoise<4>> m_terrainNoise;
+    std::unique_ptr<FractalNoise<3>> m_detailNoise;
+    std::unique_ptr<FractalNoise<2>> m_biomeNoise;
+    std::unique_ptr<FractalNoise<2>> m_caveNoise;
     std::unique_ptr<FastNoiseLite> m_treeNoise;
     std::unique_ptr<FastNoiseLite> m_oreNoise;
 
     // Generation settings
     GenerationSettings m_settings;
 
+    std::unique_ptr<ColumnCache> m_columnCache;
+
+    // Enough for the whole load area plus prefetch (~1.3 KB per column)
+    static constexpr size_t COLUMN_CACHE_CAPACITY = 1024;
+
+    // Trees reach at most this far above the surface block
+    static constexpr int TREE_CLEARANCE = 10;
+    // ... and this far sideways from the trunk
+    static constexpr int TREE_RADIUS = 2;
+    // Ore veins reach this far from their center
+    static constexpr int VEIN_RADIUS = 1;
+    // Biome grid spacing in blocks and its points per chunk column, edges included
+    static constexpr int BIOME_CELL = 4;
+    static constexpr int BIOME_GRID_POINTS = Chunk::SIZE / BIOME_CELL + 1;
+    static constexpr int BIOME_GRID_AREA = BIOME_GRID_POINTS * BIOME_GRID_POINTS;
+    static_assert(Chunk::SIZE % BIOME_CELL == 0, "Biome cells must tile a chunk");
+
+    // Blocks below terrainHeight - SUBSURFACE_DEPTH are always stone
+    static constexpr int SUBSURFACE_DEPTH = 3;
+
     // Seeds for different noise layers
     static constexpr int TERRAIN_SEED = 12345;
     static constexpr int DETAIL_SEED = 54321;
@@ -87,4 +215,12 @@ private:
     static constexpr int CAVE_SEED = 13579;
     static constexpr int TREE_SEED = 24680;
     static constexpr int ORE_SEED = 11111;
+
+    // Salts for the independent positional decisions
+    static constexpr uint32_t SALT_TREE_CHANCE = 1;
+    static constexpr uint32_t SALT_TREE_HEIGHT = 2;
+    static constexpr uint32_t SALT_ORE_CHANCE = 3;
+    static constexpr uint32_t SALT_ORE_CENTER = 4; // +0..2, one per axis
+    static constexpr uint32_t SALT_ORE_SIZE = 7;
+    static constexpr uint32_t SALT_ORE_BLOCK = 8;  // +3 * block + axis
 };
\ No newline at end of file
@@ -0,0 +1,301 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#include "WorldStorage.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+WorldStorage::WorldStorage(ChunkPool& chunkPool)
+    : m_chunkPool(chunkPool) {
+}
+
+WorldStorage::~WorldStorage() {
+    Close();
+}
+
+bool WorldStorage::Open(const std::string& directory, LoadHandler loadHandler) {
+    if (IsOpen()) {
+        return true;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        std::cerr << "Failed to create world directory " << directory << ": " << error.message() << std::endl;
+        return false;
+    }
+
+    m_directory = directory;
+    m_loadHandler = std::move(loadHandler);
+
+    if (!m_editJournal.Open(directory)) {
+        return false;
+    }
+
+    // Index which regions exist so MayContain() never touches the disk
+    size_t regionCount = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        glm::ivec2 regionPosition;
+        if (entry.is_regular_file() && RegionFile::ParseFileName(entry.path().filename().string(), regionPosition)) {
+            m_knownRegions.insert(regionPosition);
+            regionCount++;
+        }
+    }
+
+    m_shouldStop = false;
+    m_thread = std::thread(&WorldStorage::IOThreadFunc, this);
+
+    std::cout << "World storage opened at " << directory << " (" << regionCount << " regions)" << std::endl;
+    return true;
+}
+
+void WorldStorage::Close() {
+    if (!IsOpen()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shouldStop = true;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+
+    m_openRegions.clear();
+    std::cout << "World storage closed (" << m_savedCount.load() << " chunks saved)" << std::endl;
+}
+
+bool WorldStorage::MayContain(const glm::ivec3& position) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_knownRegions.count(RegionFile::GetRegionPosition(position)) > 0;
+}
+
+void WorldStorage::RequestLoad(const glm::ivec3& position) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_loadRequests.push_back(position);
+    }
+    m_condition.notify_one();
+}
+
+void WorldStorage::Save(ChunkSnapshot&& snapshot) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_knownRegions.insert(RegionFile::GetRegionPosition(snapshot.position));
+        m_pendingWrites[snapshot.position] = std::move(snapshot); // Newer snapshot replaces a queued one
+        m_saveSequence++;
+    }
+    m_condition.notify_one();
+}
+
+void WorldStorage::Flush() {
+    if (!IsOpen()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    uint64_t target = ++m_saveSequence;
+    m_commitRequested = true;
+    m_condition.notify_one();
+    m_flushedCondition.wait(lock, [this, target] { return m_writtenSequence >= target; });
+}
+
+size_t WorldStorage::GetPendingWriteCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pendingWrites.size();
+}
+
+void WorldStorage::IOThreadFunc() {
+    using Clock = std::chrono::steady_clock;
+    const auto compactionInterval = std::chrono::duration<float>(COMPACTION_INTERVAL);
+    const auto commitInterval = std::chrono::duration<float>(JOURNAL_COMMIT_INTERVAL);
+    auto lastCompaction = Clock::now();
+    auto lastCommit = Clock::now();
+
+    std::unordered_map<glm::ivec3, ChunkSnapshot, ivec3Hash> batch;
+    std::vector<glm::ivec3> loads;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_condition.wait_for(lock, commitInterval, [this] {
+            return m_shouldStop || m_commitRequested || !m_loadRequests.empty() || !m_pendingWrites.empty();
+        });
+
+        // Take everything queued so far as one batch
+        batch.swap(m_pendingWrites);
+        loads.swap(m_loadRequests);
+        uint64_t sequence = m_saveSequence;
+        bool stopping = m_shouldStop;
+        bool commitRequested = m_commitRequested;
+        m_commitRequested = false;
+        lock.unlock();
+
+        // Loads first - they gate what the player sees. A position with a
+        // queued save is answered from the snapshot, never from stale disk data.
+        for (const glm::ivec3& position : loads) {
+            ServeLoad(position, batch);
+        }
+        loads.clear();
+
+        // Saves that failed to reach the disk go out again with this batch,
+        // unless a newer snapshot of the chunk replaced them meanwhile
+        for (auto& [position, snapshot] : m_failedWrites) {
+            batch.emplace(position, std::move(snapshot));
+        }
+        m_failedWrites.clear();
+
+        if (!batch.empty()) {
+            WriteBatch(batch);
+            batch.clear();
+        }
+
+        // Group commit: every edit since the last commit in one append per region
+        if (stopping || commitRequested || Clock::now() - lastCommit >= commitInterval) {
+            m_editJournal.Commit();
+            lastCommit = Clock::now();
+        }
+
+        if (Clock::now() - lastCompaction >= compactionInterval) {
+            CompactRegions();
+            lastCompaction = Clock::now();
+        }
+
+        lock.lock();
+        m_writtenSequence = sequence;
+        m_flushedCondition.notify_all();
+
+        if (stopping && m_loadRequests.empty() && m_pendingWrites.empty()) {
+            if (!m_failedWrites.empty()) {
+                std::cerr << "World storage closing with " << m_failedWrites.size() << " unsaved chunks" << std::endl;
+            }
+            break;
+        }
+    }
+}
+
+void WorldStorage::ServeLoad(const glm::ivec3& position,
+                             const std::unordered_map<glm::ivec3, ChunkSnapshot, ivec3Hash>& batch) {
+    ChunkSnapshot snapshot;
+    bool found = false;
+
+    auto batchIt = batch.find(position);
+    if (batchIt != batch.end()) {
+        snapshot = batchIt->second;
+        found = true;
+    } else {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto pendingIt = m_pendingWrites.find(position);
+        if (pendingIt != m_pendingWrites.end()) {
+            snapshot = pendingIt->second;
+            found = true;
+        }
+    }
+
+    if (!found) {
+        auto failedIt = m_failedWrites.find(position);
+        if (failedIt != m_failedWrites.end()) {
+            snapshot = failedIt->second;
+            found = true;
+        }
+    }
+
+    if (!found) {
+        thread_local std::vector<uint8_t> payload;
+        RegionFile* region = GetRegion(RegionFile::GetRegionPosition(position), false);
+        if (region && region->Read(position, payload)) {
+            found = ChunkCodec::Decode(payload.data(), payload.size(), snapshot);
+            if (!found) {
+                std::cerr << "Corrupt chunk record at (" << position.x << ", " << position.y << ", "
+                          << position.z << "), regenerating" << std::endl;
+            }
+        }
+    }
+
+    std::unique_ptr<Chunk> chunk;
+    if (found) {
+        chunk = m_chunkPool.Acquire(position);
+        if (chunk->LoadBlockData(snapshot.palette, snapshot.indices)) {
+            m_editJournal.ApplyEdits(*chunk);
+            m_loadedCount.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            m_chunkPool.Release(std::move(chunk));
+        }
+    }
+
+    m_loadHandler(position, std::move(chunk));
+}
+
+void WorldStorage::WriteBatch(std::unordered_map<glm::ivec3, ChunkSnapshot, ivec3Hash>& batch) {
+    // Group records per region so every touched file is flushed once
+    std::unordered_map<glm::ivec2, std::vector<std::pair<glm::ivec3, std::vector<uint8_t>>>, ivec2Hash> regions;
+    for (const auto& [position, snapshot] : batch) {
+        auto& records = regions[RegionFile::GetRegionPosition(position)];
+        records.emplace_back(position, std::vector<uint8_t>());
+        ChunkCodec::Encode(snapshot, records.back().second);
+    }
+
+    for (const auto& [regionPosition, records] : regions) {
+        RegionFile* region = GetRegion(regionPosition, true);
+        if (region && region->Write(records)) {
+            m_savedCount.fetch_add(records.size(), std::memory_order_relaxed);
+            continue;
+        }
+
+        // Nothing of the batch is indexed; keep the snapshots for the next one
+        for (const auto& [position, payload] : records) {
+            m_failedWrites[position] = std::move(batch[position]);
+        }
+    }
+}
+
+void WorldStorage::CompactRegions() {
+    m_editJournal.Compact();
+
+    for (auto& [regionPosition, openRegion] : m_openRegions) {
+        if (openRegion.file->NeedsCompaction()) {
+            uint64_t before = openRegion.file->GetLiveBytes() + openRegion.file->GetDeadBytes();
+            if (openRegion.file->Compact()) {
+                std::cout << "Compacted region " << RegionFile::GetFileName(regionPosition) << ": "
+                          << before / 1024 << " KB -> " << openRegion.file->GetLiveBytes() / 1024 << " KB" << std::endl;
+            }
+        }
+    }
+}
+
+RegionFile* WorldStorage::GetRegion(const glm::ivec2& regionPosition, bool create) {
+    auto it = m_openRegions.find(regionPosition);
+    if (it != m_openRegions.end()) {
+        it->second.lastUse = ++m_useCounter;
+        return it->second.file.get();
+    }
+
+    std::string path = (std::filesystem::path(m_directory) / RegionFile::GetFileName(regionPosition)).string();
+    if (!create && !std::filesystem::exists(path)) {
+        return nullptr;
+    }
+
+    // Keep the number of open file handles bounded
+    if (m_openRegions.size() >= MAX_OPEN_REGIONS) {
+        auto oldest = m_openRegions.begin();
+        for (auto candidate = m_openRegions.begin(); candidate != m_openRegions.end(); ++candidate) {
+            if (candidate->second.lastUse < oldest->second.lastUse) {
+                oldest = candidate;
+            }
+        }
+        if (oldest->second.file->NeedsCompaction()) {
+            oldest->second.file->Compact();
+        }
+        m_openRegions.erase(oldest);
+    }
+
+    auto file = std::make_unique<RegionFile>(path);
+    if (!file->Open()) {
+        return nullptr;
+    }
+
+    RegionFile* region = file.get();
+    m_openRegions[regionPosition] = {std::move(file), ++m_useCounter};
+    return region;
+}
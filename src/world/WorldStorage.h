@@ -0,0 +1,118 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+#pragma once
+
+#include "ChunkCodec.h"
+#include "ChunkPool.h"
+#include "EditJournal.h"
+#include "RegionFile.h"
+#include "../utils/Math.h"
+#include <glm/glm.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Persistent chunk storage on top of region files.
+// All disk access happens on a dedicated I/O thread: saves are queued and
+// written in batches (one flush per region), loads are answered through the
+// load handler. Region files are compacted in the background when idle.
+// Single block edits go to the edit journal instead, which is group-committed
+// every JOURNAL_COMMIT_INTERVAL.
+class WorldStorage {
+public:
+    // Called on the I/O thread. chunk is nullptr when the position isn't stored
+    // (or the record is unreadable) and has to be generated instead.
+    using LoadHandler = std::function<void(const glm::ivec3& position, std::unique_ptr<Chunk> chunk)>;
+
+    static constexpr size_t MAX_OPEN_REGIONS = 32;
+    static constexpr float COMPACTION_INTERVAL = 30.0f;   // Seconds between compaction passes
+    static constexpr float JOURNAL_COMMIT_INTERVAL = 2.0f; // Seconds between edit journal commits
+
+    explicit WorldStorage(ChunkPool& chunkPool);
+    ~WorldStorage();
+
+    WorldStorage(const WorldStorage&) = delete;
+    WorldStorage& operator=(const WorldStorage&) = delete;
+
+    // Creates the directory if needed, indexes existing regions and starts the I/O thread
+    bool Open(const std::string& directory, LoadHandler loadHandler);
+
+    // Writes everything still queued and stops the I/O thread
+    void Close();
+    bool IsOpen() const { return m_thread.joinable(); }
+
+    // Cheap check without disk access: false means the chunk certainly isn't stored
+    bool MayContain(const glm::ivec3& position) const;
+
+    // Queue operations, never block on disk
+    void RequestLoad(const glm::ivec3& position);
+    void Save(ChunkSnapshot&& snapshot);
+
+    // Any thread. Edits relative to the generator output.
+    void RecordEdit(const glm::ivec3& chunkPosition, int x, int y, int z, BlockType type) {
+        m_editJournal.RecordEdit(chunkPosition, x, y, z, type);
+    }
+    size_t ApplyEdits(Chunk& chunk) const { return m_editJournal.ApplyEdits(chunk); }
+    bool HasEdits(const glm::ivec3& chunkPosition) const { return m_editJournal.HasEdits(chunkPosition); }
+
+    // Blocks until every save and edit recorded so far is on disk (or, after a
+    // failed write, queued for a retry)
+    void Flush();
+
+    // Statistics
+    size_t GetPendingWriteCount() const;
+    size_t GetLoadedCount() const { return m_loadedCount.load(std::memory_order_relaxed); }
+    size_t GetSavedCount() const { return m_savedCount.load(std::memory_order_relaxed); }
+    const EditJournal& GetEditJournal() const { return m_editJournal; }
+
+private:
+    void IOThreadFunc();
+    void WriteBatch(std::unordered_map<glm::ivec3, ChunkSnapshot, ivec3Hash>& batch);
+    void ServeLoad(const glm::ivec3& position, const std::unordered_map<glm::ivec3, ChunkSnapshot, ivec3Hash>& batch);
+    void CompactRegions();
+    RegionFile* GetRegion(const glm::ivec2& regionPosition, bool create);
+
+    ChunkPool& m_chunkPool;
+    LoadHandler m_loadHandler;
+    std::string m_directory;
+
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::condition_variable m_flushedCondition;
+    bool m_shouldStop = false;
+    bool m_commitRequested = false;
+
+    EditJournal m_editJournal;
+
+    // Guarded by m_mutex. Saves are coalesced per position until the I/O
+    // thread takes them as one batch.
+    std::vector<glm::ivec3> m_loadRequests;
+    std::unordered_map<glm::ivec3, ChunkSnapshot, ivec3Hash> m_pendingWrites;
+    std::unordered_set<glm::ivec2, ivec2Hash> m_knownRegions; // On disk or about to be
+    uint64_t m_saveSequence = 0;    // Saves queued so far
+    uint64_t m_writtenSequence = 0; // Saves the I/O thread has written (or queued for a retry)
+
+    // Saves whose region write failed, retried with the next batch (I/O thread only)
+    std::unordered_map<glm::ivec3, ChunkSnapshot, ivec3Hash> m_failedWrites;
+
+    // Open region files with last use stamp (I/O thread only)
+    struct OpenRegion {
+        std::unique_ptr<RegionFile> file;
+        uint64_t lastUse;
+    };
+    std::unordered_map<glm::ivec2, OpenRegion, ivec2Hash> m_openRegions;
+    uint64_t m_useCounter = 0;
+
+    std::atomic<size_t> m_loadedCount{0};
+    std::atomic<size_t> m_savedCount{0};
+};
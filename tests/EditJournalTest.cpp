@@ -0,0 +1,132 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+// EditJournal crash safety: a commit that only partly reaches the disk must
+// not cost the edits committed after it. Short writes are real ones - the
+// file size limit (RLIMIT_FSIZE) cuts the append, as a full disk would.
+
+#include "../src/world/EditJournal.h"
+#include <sys/resource.h>
+#include <unistd.h>
+#include <csignal>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #condition \
+                      << std::endl;                                                   \
+            g_failures++;                                                             \
+        }                                                                             \
+    } while (false)
+
+// Appends past limitBytes (file size) fail part way while this is alive
+class FileSizeLimit {
+public:
+    explicit FileSizeLimit(rlim_t limitBytes) {
+        getrlimit(RLIMIT_FSIZE, &m_previous);
+        rlimit limit = m_previous;
+        limit.rlim_cur = limitBytes;
+        setrlimit(RLIMIT_FSIZE, &limit);
+    }
+
+    ~FileSizeLimit() {
+        setrlimit(RLIMIT_FSIZE, &m_previous);
+    }
+
+private:
+    rlimit m_previous{};
+};
+
+const glm::ivec3 CHUNK(0, 0, 0);
+
+// Every edit of the list applied, read back through a fresh journal
+bool HasAllEdits(const std::string& directory, std::initializer_list<glm::ivec3> blocks, BlockType type) {
+    EditJournal journal;
+    if (!journal.Open(directory)) {
+        return false;
+    }
+
+    Chunk chunk(CHUNK);
+    journal.ApplyEdits(chunk);
+    for (const glm::ivec3& block : blocks) {
+        if (chunk.GetBlock(block.x, block.y, block.z) != type) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Torn file header: the next commit has to write a fresh header
+void TestShortWriteOfNewFile(const std::string& directory) {
+    const std::string path = (std::filesystem::path(directory) / "r.0.0.vxj").string();
+
+    EditJournal journal;
+    CHECK(journal.Open(directory));
+
+    journal.RecordEdit(CHUNK, 1, 2, 3, BlockType::Stone);
+    {
+        FileSizeLimit limit(4); // Half of the header
+        CHECK(journal.Commit() == 0);
+    }
+    CHECK(!std::filesystem::exists(path));
+    CHECK(journal.GetPendingCount() == 1);
+
+    journal.RecordEdit(CHUNK, 4, 5, 6, BlockType::Stone);
+    CHECK(journal.Commit() == 2);
+
+    CHECK(HasAllEdits(directory, {{1, 2, 3}, {4, 5, 6}}, BlockType::Stone));
+}
+
+// Torn commit after good ones: it must not hide the commits appended later
+void TestShortWriteOfCommit(const std::string& directory) {
+    const std::string path = (std::filesystem::path(directory) / "r.0.0.vxj").string();
+
+    EditJournal journal;
+    CHECK(journal.Open(directory));
+
+    journal.RecordEdit(CHUNK, 7, 8, 9, BlockType::Sand);
+    const uintmax_t goodBytes = std::filesystem::file_size(path);
+    {
+        FileSizeLimit limit(goodBytes + 10); // Commit header and a few body bytes
+        CHECK(journal.Commit() == 0);
+    }
+    CHECK(std::filesystem::file_size(path) == goodBytes);
+
+    journal.RecordEdit(CHUNK, 10, 11, 12, BlockType::Sand);
+    CHECK(journal.Commit() == 2);
+
+    CHECK(HasAllEdits(directory, {{1, 2, 3}, {4, 5, 6}}, BlockType::Stone));
+    CHECK(HasAllEdits(directory, {{7, 8, 9}, {10, 11, 12}}, BlockType::Sand));
+}
+
+} // namespace
+
+int main() {
+    // Exceeding the size limit raises SIGXFSZ; we want the failed write instead
+    std::signal(SIGXFSZ, SIG_IGN);
+
+    const std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / ("edit_journal_test_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    TestShortWriteOfNewFile(directory.string());
+    TestShortWriteOfCommit(directory.string());
+
+    std::filesystem::remove_all(directory);
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "EditJournal tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,126 @@
+//
+// Created by mrsomfergo on 13.07.2025.
+//
+
+// RegionFile crash safety: a batch that only partly reaches the disk must
+// leave the index on the previous records and must not hide the batches
+// written after it. Short writes come from the file size limit (RLIMIT_FSIZE).
+
+#include "../src/world/RegionFile.h"
+#include <sys/resource.h>
+#include <unistd.h>
+#include <csignal>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #condition \
+                      << std::endl;                                                   \
+            g_failures++;                                                             \
+        }                                                                             \
+    } while (false)
+
+// Appends past limitBytes (file size) fail part way while this is alive
+class FileSizeLimit {
+public:
+    explicit FileSizeLimit(rlim_t limitBytes) {
+        getrlimit(RLIMIT_FSIZE, &m_previous);
+        rlimit limit = m_previous;
+        limit.rlim_cur = limitBytes;
+        setrlimit(RLIMIT_FSIZE, &limit);
+    }
+
+    ~FileSizeLimit() {
+        setrlimit(RLIMIT_FSIZE, &m_previous);
+    }
+
+private:
+    rlimit m_previous{};
+};
+
+using Records = std::vector<std::pair<glm::ivec3, std::vector<uint8_t>>>;
+
+bool HasPayload(RegionFile& region, const glm::ivec3& position, uint8_t fill, size_t length) {
+    std::vector<uint8_t> payload;
+    return region.Read(position, payload) && payload == std::vector<uint8_t>(length, fill);
+}
+
+// Torn batch after good ones: old records stay readable, later batches survive a reopen
+void TestShortWrite(const std::string& directory) {
+    const std::string path = (std::filesystem::path(directory) / RegionFile::GetFileName(glm::ivec2(0, 0))).string();
+    const glm::ivec3 first(0, 0, 0);
+    const glm::ivec3 second(1, 0, 0);
+
+    {
+        RegionFile region(path);
+        CHECK(region.Open());
+        CHECK(region.Write({{first, std::vector<uint8_t>(100, 1)}}));
+        const uintmax_t goodBytes = std::filesystem::file_size(path);
+
+        // Rewrite of the first chunk plus a new one, cut inside the second record
+        Records torn = {{first, std::vector<uint8_t>(100, 2)}, {second, std::vector<uint8_t>(100, 2)}};
+        {
+            FileSizeLimit limit(goodBytes + 150);
+            CHECK(!region.Write(torn));
+        }
+        CHECK(std::filesystem::file_size(path) == goodBytes);
+        CHECK(HasPayload(region, first, 1, 100));
+        CHECK(!region.Contains(second));
+
+        // The retry lands where the torn batch started
+        CHECK(region.Write(torn));
+        CHECK(region.Write({{second, std::vector<uint8_t>(50, 3)}}));
+    }
+
+    RegionFile reopened(path);
+    CHECK(reopened.Open());
+    CHECK(HasPayload(reopened, first, 2, 100));
+    CHECK(HasPayload(reopened, second, 3, 50));
+}
+
+// Failed compaction: no temp file left behind, the original stays in use
+void TestShortCompaction(const std::string& directory) {
+    const std::string path = (std::filesystem::path(directory) / RegionFile::GetFileName(glm::ivec2(1, 0))).string();
+    const glm::ivec3 chunk(32, 0, 0);
+
+    RegionFile region(path);
+    CHECK(region.Open());
+    CHECK(region.Write({{chunk, std::vector<uint8_t>(100, 4)}}));
+    {
+        FileSizeLimit limit(50); // The temp file can't take the record
+        CHECK(!region.Compact());
+    }
+    CHECK(!std::filesystem::exists(path + ".tmp"));
+    CHECK(HasPayload(region, chunk, 4, 100));
+}
+
+} // namespace
+
+int main() {
+    // Exceeding the size limit raises SIGXFSZ; we want the failed write instead
+    std::signal(SIGXFSZ, SIG_IGN);
+
+    const std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / ("region_file_test_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    TestShortWrite(directory.string());
+    TestShortCompaction(directory.string());
+
+    std::filesystem::remove_all(directory);
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "RegionFile tests passed" << std::endl;
+    return 0;
+}